@@ -7,25 +7,57 @@
 
 #include "ADC.h"
 
+static uint8_t perfilActual = ADC_PERFIL_PRECISION;
+static uint8_t referenciaActual = ADC_REF_DEFECTO;
 
 void ADC_init(void)
 {
-	ADMUX |=  (1<<REFS0);		//Seleccionar el voltaje de referencia
-	ADMUX &=~ (1<<REFS1);
-	ADMUX &=~ (1<<ADLAR);		//Ajustar el resultado
+	ADC_config(ADC_PERFIL_DEFECTO, ADC_REF_DEFECTO);
+}
+
+
+void ADC_config(uint8_t perfil, uint8_t referencia)
+{
+	// El valor llega de un registro I2C: REFS1:REFS0 = 2 est reservado
+	if (referencia != ADC_REF_AREF && referencia != ADC_REF_AVCC && referencia != ADC_REF_INTERNA)
+	{
+		referencia = ADC_REF_DEFECTO;
+	}
+	referenciaActual = referencia;
+	ADMUX = (ADMUX & 0x0F) | (referencia << REFS0);	//Seleccionar el voltaje de referencia
+
+	if (perfil == ADC_PERFIL_RAPIDO)
+	{
+		ADMUX |= (1<<ADLAR);		//Resultado ajustado a la izquierda: los 8 bits altos quedan en ADCH
+#if ADC_PRESCALER_RAPIDO == 32
+		ADCSRA = (ADCSRA & 0xF8) | (1<<ADPS2) | (1<<ADPS0);	// divisor = 32  16000/32 = 500 KHz
+#else
+		ADCSRA = (ADCSRA & 0xF8) | (1<<ADPS2);				// divisor = 16  16000/16 = 1 MHz
+#endif
+	}
+	else
+	{
+		perfil = ADC_PERFIL_PRECISION;
+		ADMUX &=~ (1<<ADLAR);		//Ajustar el resultado a la derecha (10 bits)
+		ADCSRA |= (1<<ADPS2) | (1<<ADPS1) | (1<<ADPS0);		// divisor = 128  16000/128 = 125 KHz
+	}
+	perfilActual = perfil;
 
-	ADCSRA |= (1<<ADPS0);		// divisor = 128  16000/128 = 125 KHz
-	ADCSRA |= (1<<ADPS1);
-	ADCSRA |= (1<<ADPS2);
 	ADCSRA |= (1<<ADEN);		// Encendemos en ADC
+
+	// La primera conversion despues de cambiar la referencia no es confiable
+	ADCSRA |= (1<<ADSC);
+	while(ADCSRA & (1<<ADSC));
 }
 
 
-uint16_t ADC_read(uint8_t canal)
+uint8_t ADC_perfil(void)
 {
-	canal &= 0b00000111;            // Limitar la entrada a canales 0-7 (la mayora de AVR tienen 8 canales ADC)
-	ADMUX = (ADMUX & 0xF0) | canal; // Conservar los 4 bits superiores (config) y establecer los bits de seleccin de canal
-	ADCSRA |= (1<<ADSC);            // Inicia la conversin
-	while(ADCSRA & (1<<ADSC));      // Esperar hasta que se complete la conversin
-	return ADC;                     // Devolver el valor del ADC
-}
\ No newline at end of file
+	return perfilActual;
+}
+
+
+uint8_t ADC_referencia(void)
+{
+	return referenciaActual;
+}
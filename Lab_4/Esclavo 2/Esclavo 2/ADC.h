@@ -11,7 +11,37 @@
 
 #include <avr/io.h>
 
+// Perfiles de adquisicion
+#define ADC_PERFIL_PRECISION	0	// 10 bits, ADC a 125 kHz (prescaler 128), ~9.6 kSPS
+#define ADC_PERFIL_RAPIDO		1	// 8 bits con ADLAR (solo ADCH), ADC a 1 MHz (prescaler 16), ~77 kSPS
+
+// Prescaler del perfil rapido: 16 -> 1 MHz, 32 -> 500 kHz
+#ifndef ADC_PRESCALER_RAPIDO
+#define ADC_PRESCALER_RAPIDO	16
+#endif
+
+// Voltaje de referencia (valor de los bits REFS1:REFS0)
+#define ADC_REF_AREF			0	// Pin AREF externo
+#define ADC_REF_AVCC			1	// AVCC con capacitor en AREF
+#define ADC_REF_INTERNA			3	// Referencia interna de 1.1 V
+
+// Configuracion que usa ADC_init (se puede cambiar con -D al compilar)
+#ifndef ADC_PERFIL_DEFECTO
+#define ADC_PERFIL_DEFECTO		ADC_PERFIL_PRECISION
+#endif
+#ifndef ADC_REF_DEFECTO
+#define ADC_REF_DEFECTO			ADC_REF_AVCC
+#endif
+
 void ADC_init(void);
-uint16_t ADC_read(uint8_t canal);
+
+// Cambia el perfil y la referencia; descarta la primera conversion tras el cambio.
+// Un perfil invalido queda en precision y una referencia invalida en ADC_REF_DEFECTO
+void ADC_config(uint8_t perfil, uint8_t referencia);
+uint8_t ADC_perfil(void);
+uint8_t ADC_referencia(void);
+
+// No hay lectura bloqueante: las conversiones las dispara el Timer1 y las
+// recibe la ISR del ADC (ver Muestreo.h)
 
 #endif /* ADC_H_ */
\ No newline at end of file
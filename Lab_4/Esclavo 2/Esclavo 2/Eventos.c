@@ -0,0 +1,183 @@
+/*
+ * Eventos.c
+ *
+ * Created: 01/09/2025 07:48:03
+ *  Author: valen
+ */ 
+
+#include <util/atomic.h>
+#include "Eventos.h"
+
+#define ZONA_DENTRO	0
+#define ZONA_BAJA	1
+#define ZONA_ALTA	2
+
+typedef struct
+{
+	uint8_t tipo;
+	uint16_t valor;
+	uint32_t tiempo;
+} Evento;
+
+// Cola circular: se agrega desde el programa principal y se saca desde la ISR
+// de TWI, por eso primero y cantidad se modifican siempre con las
+// interrupciones bloqueadas
+static Evento cola[EVENTOS_COLA];
+static volatile uint8_t primero = 0;
+static volatile uint8_t cantidad = 0;
+static volatile uint8_t perdidos = 0;
+
+// Limites
+static uint16_t umbralBajo = EVENTOS_BAJO_DEFECTO;
+static uint16_t umbralAlto = EVENTOS_ALTO_DEFECTO;
+static uint8_t histeresis = EVENTOS_HISTERESIS_DEFECTO;
+static uint16_t tasaMax = EVENTOS_TASA_DEFECTO;
+static uint32_t intervaloTasa = EVENTOS_TASA_MS_DEFECTO * 1000UL;	// us
+
+// Estado de la comparacion
+static uint8_t zona = ZONA_DENTRO;
+static uint8_t hayReferencia = 0;
+static uint16_t valorReferencia;	// Valor al inicio del intervalo de tasa
+static uint32_t tiempoReferencia;
+
+void Eventos_Config(uint16_t bajo, uint16_t alto, uint8_t hist, uint16_t tasa, uint8_t tasaMs)
+{
+	umbralBajo = bajo;
+	umbralAlto = alto;
+	histeresis = hist;
+	tasaMax = tasa;
+	intervaloTasa = (tasaMs ? tasaMs : 1) * 1000UL;
+	hayReferencia = 0;	// El intervalo de tasa vuelve a empezar
+}
+
+static uint8_t agregar(uint8_t tipo, uint16_t valor, uint32_t tiempo)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (cantidad < EVENTOS_COLA)
+		{
+			Evento *e = &cola[(primero + cantidad) & (EVENTOS_COLA - 1)];
+			e->tipo = tipo;
+			e->valor = valor;
+			e->tiempo = tiempo;
+			cantidad++;
+		}
+		else if (perdidos < 255)
+		{
+			perdidos++;
+		}
+	}
+	return 1;
+}
+
+uint8_t Eventos_Evaluar(uint16_t valor, uint32_t tiempo)
+{
+	uint8_t nuevos = 0;
+
+	// Ventana con histeresis: para salir de una zona hay que pasar el umbral
+	// por "histeresis" cuentas, asi el ruido no genera eventos repetidos
+	switch (zona)
+	{
+		case ZONA_BAJA:
+			if ((uint32_t)valor > (uint32_t)umbralBajo + histeresis)
+			{
+				zona = ZONA_DENTRO;
+				nuevos |= agregar(EV_BAJO_SALE, valor, tiempo);
+			}
+			break;
+
+		case ZONA_ALTA:
+			if ((int32_t)valor < (int32_t)umbralAlto - histeresis)
+			{
+				zona = ZONA_DENTRO;
+				nuevos |= agregar(EV_ALTO_SALE, valor, tiempo);
+			}
+			break;
+	}
+	if (zona == ZONA_DENTRO)
+	{
+		if (valor < umbralBajo)
+		{
+			zona = ZONA_BAJA;
+			nuevos |= agregar(EV_BAJO_ENTRA, valor, tiempo);
+		}
+		else if (valor > umbralAlto)
+		{
+			zona = ZONA_ALTA;
+			nuevos |= agregar(EV_ALTO_ENTRA, valor, tiempo);
+		}
+	}
+
+	// Limite de cambio: se compara con el valor al inicio de cada intervalo
+	if (!hayReferencia)
+	{
+		hayReferencia = 1;
+		valorReferencia = valor;
+		tiempoReferencia = tiempo;
+	}
+	else if (tiempo - tiempoReferencia >= intervaloTasa)
+	{
+		if (tasaMax)
+		{
+			if (valor > valorReferencia && valor - valorReferencia > tasaMax)
+			{
+				nuevos |= agregar(EV_TASA_SUBE, valor, tiempo);
+			}
+			else if (valor < valorReferencia && valorReferencia - valor > tasaMax)
+			{
+				nuevos |= agregar(EV_TASA_BAJA, valor, tiempo);
+			}
+		}
+		valorReferencia = valor;
+		tiempoReferencia = tiempo;
+	}
+
+	return nuevos;
+}
+
+uint8_t Eventos_Pendientes(void)
+{
+	return cantidad;
+}
+
+uint8_t Eventos_Perdidos(void)
+{
+	return perdidos;
+}
+
+void Eventos_Primero(uint8_t *destino)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (cantidad)
+		{
+			Evento *e = &cola[primero];
+			destino[0] = e->tipo;
+			destino[1] = e->valor;
+			destino[2] = e->valor >> 8;
+			destino[3] = e->tiempo;
+			destino[4] = e->tiempo >> 8;
+			destino[5] = e->tiempo >> 16;
+			destino[6] = e->tiempo >> 24;
+		}
+		else
+		{
+			for (uint8_t i = 0; i < EVENTO_BYTES; i++)
+			{
+				destino[i] = 0;
+			}
+		}
+	}
+}
+
+void Eventos_Sacar(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (cantidad)
+		{
+			primero = (primero + 1) & (EVENTOS_COLA - 1);
+			cantidad--;
+		}
+	}
+}
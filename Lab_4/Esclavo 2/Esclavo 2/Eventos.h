@@ -0,0 +1,69 @@
+/*
+ * Eventos.h
+ *
+ * Created: 01/09/2025 07:48:26
+ *  Author: valen
+ */ 
+
+
+#ifndef EVENTOS_H_
+#define EVENTOS_H_
+
+#include <stdint.h>
+
+// Comparacion del valor filtrado contra una ventana (umbral bajo / alto con
+// histeresis) y contra un limite de cambio por intervalo de tiempo. Solo se
+// genera un evento al cruzar un limite; los eventos esperan en una cola hasta
+// que el maestro los lee.
+//
+// Los umbrales van en la misma escala que REG_ADC16 (depende del filtro).
+// Con umbral bajo 0, umbral alto 0xFFFF y tasa maxima 0 no hay eventos.
+#define EVENTOS_COLA		8
+
+// Tipos de evento
+#define EV_BAJO_ENTRA		1	// El valor bajo del umbral bajo
+#define EV_BAJO_SALE		2	// El valor volvio sobre umbral bajo + histeresis
+#define EV_ALTO_ENTRA		3	// El valor supero el umbral alto
+#define EV_ALTO_SALE		4	// El valor volvio bajo umbral alto - histeresis
+#define EV_TASA_SUBE		5	// Subio mas que la tasa maxima en un intervalo
+#define EV_TASA_BAJA		6	// Bajo mas que la tasa maxima en un intervalo
+
+#define EVENTO_BYTES		7	// tipo (u8), valor (u16), tiempo de red en us (u32)
+
+// Configuracion inicial (se puede cambiar con -D al compilar o por I2C)
+#ifndef EVENTOS_BAJO_DEFECTO
+#define EVENTOS_BAJO_DEFECTO		0
+#endif
+#ifndef EVENTOS_ALTO_DEFECTO
+#define EVENTOS_ALTO_DEFECTO		0xFFFF
+#endif
+#ifndef EVENTOS_HISTERESIS_DEFECTO
+#define EVENTOS_HISTERESIS_DEFECTO	4
+#endif
+#ifndef EVENTOS_TASA_DEFECTO
+#define EVENTOS_TASA_DEFECTO		0
+#endif
+#ifndef EVENTOS_TASA_MS_DEFECTO
+#define EVENTOS_TASA_MS_DEFECTO		100
+#endif
+
+// Cambia los limites (tasaMax = 0 desactiva el limite de cambio)
+void Eventos_Config(uint16_t bajo, uint16_t alto, uint8_t histeresis, uint16_t tasaMax, uint8_t tasaMs);
+
+// Evalua un valor nuevo tomado en "tiempo" (us de red); devuelve 1 si cambio
+// la cola (se agrego un evento o se perdio por estar llena)
+uint8_t Eventos_Evaluar(uint16_t valor, uint32_t tiempo);
+
+// Eventos en la cola
+uint8_t Eventos_Pendientes(void);
+
+// Eventos descartados por tener la cola llena (se satura en 255)
+uint8_t Eventos_Perdidos(void);
+
+// Copia el evento mas viejo en EVENTO_BYTES bytes (ceros si no hay)
+void Eventos_Primero(uint8_t *destino);
+
+// Quita el evento mas viejo de la cola
+void Eventos_Sacar(void);
+
+#endif /* EVENTOS_H_ */
@@ -0,0 +1,161 @@
+/*
+ * Filtros.c
+ *
+ * Created: 21/08/2025 07:34:40
+ *  Author: valen
+ */ 
+
+#include "Filtros.h"
+
+static uint8_t tipoFiltro = FILTRO_NINGUNO;
+static uint8_t param = 0;
+static uint8_t decimar = 1;
+static uint8_t cuentaDecimar = 0;
+
+// Estado compartido por los filtros (solo uno esta activo a la vez)
+static uint16_t ventana[FILTRO_VENTANA_MAX];
+static uint8_t indice = 0;
+static uint8_t llenas = 0;		// Muestras validas en la ventana
+static uint16_t acumulado = 0;	// Suma del promedio / sobremuestreo, o y*2^param del exponencial
+
+
+void Filtro_Config(uint8_t tipo, uint8_t parametro, uint8_t decimacion)
+{
+	// Limitar el parametro al rango valido de cada filtro
+	switch (tipo)
+	{
+		case FILTRO_PROMEDIO:
+			if (parametro < 1) parametro = 1;
+			if (parametro > 4) parametro = 4;		// 16 * 1023 cabe en 16 bits
+			break;
+		case FILTRO_EXPONENCIAL:
+			if (parametro < 1) parametro = 1;
+			if (parametro > 6) parametro = 6;		// 1023 * 64 cabe en 16 bits
+			break;
+		case FILTRO_MEDIANA:
+			parametro = (parametro >= 5) ? 5 : 3;
+			break;
+		case FILTRO_SOBREMUESTREO:
+			parametro = (parametro >= 2) ? 2 : 1;	// 16 * 1023 cabe en 16 bits
+			break;
+		default:
+			tipo = FILTRO_NINGUNO;
+			parametro = 0;
+			break;
+	}
+
+	tipoFiltro = tipo;
+	param = parametro;
+	decimar = decimacion ? decimacion : 1;
+	cuentaDecimar = 0;
+	indice = 0;
+	llenas = 0;
+	acumulado = 0;
+	for (uint8_t i = 0; i < FILTRO_VENTANA_MAX; i++)
+	{
+		ventana[i] = 0;
+	}
+}
+
+
+uint8_t Filtro_Bits(void)
+{
+	return (tipoFiltro == FILTRO_SOBREMUESTREO) ? 10 + param : 10;
+}
+
+
+// Mediana de 3 con comparaciones directas
+static uint16_t mediana3(uint16_t a, uint16_t b, uint16_t c)
+{
+	if (a > b) { uint16_t t = a; a = b; b = t; }
+	if (b > c) { b = c; }
+	return (a > b) ? a : b;
+}
+
+// Mediana de 5 ordenando una copia por insercion
+static uint16_t mediana5(const uint16_t *v)
+{
+	uint16_t o[5];
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		uint16_t x = v[i];
+		uint8_t j = i;
+		while (j > 0 && o[j - 1] > x)
+		{
+			o[j] = o[j - 1];
+			j--;
+		}
+		o[j] = x;
+	}
+	return o[2];
+}
+
+
+uint8_t Filtro_Procesar(uint16_t muestra, uint16_t *salida)
+{
+	uint16_t y;
+
+	switch (tipoFiltro)
+	{
+		case FILTRO_PROMEDIO:
+		{
+			uint8_t n = 1 << param;
+			acumulado -= ventana[indice];	// La ventana empieza en 0, asi que la suma es valida desde el inicio
+			ventana[indice] = muestra;
+			acumulado += muestra;
+			indice = (indice + 1) & (n - 1);
+			if (llenas < n)
+			{
+				llenas++;
+				return 0;					// Esperar a tener la ventana completa
+			}
+			y = acumulado >> param;
+			break;
+		}
+
+		case FILTRO_EXPONENCIAL:
+			if (!llenas)
+			{
+				acumulado = muestra << param;	// Arrancar en la primera muestra en vez de en 0
+				llenas = 1;
+			}
+			acumulado = acumulado - (acumulado >> param) + muestra;	// Nunca pasa de 1023 * 2^param
+			y = acumulado >> param;
+			break;
+
+		case FILTRO_MEDIANA:
+			ventana[indice] = muestra;
+			if (++indice >= param) indice = 0;
+			if (llenas < param)
+			{
+				llenas++;
+				return 0;
+			}
+			y = (param == 3) ? mediana3(ventana[0], ventana[1], ventana[2]) : mediana5(ventana);
+			break;
+
+		case FILTRO_SOBREMUESTREO:
+			acumulado += muestra;
+			if (++llenas < (1 << (2 * param)))
+			{
+				return 0;					// Aun faltan muestras para este valor
+			}
+			y = acumulado >> param;			// 4^n muestras -> n bits extra
+			acumulado = 0;
+			llenas = 0;
+			break;
+
+		default:
+			y = muestra;
+			break;
+	}
+
+	// Tasa de salida: entregar 1 de cada "decimar" valores filtrados
+	if (++cuentaDecimar < decimar)
+	{
+		return 0;
+	}
+	cuentaDecimar = 0;
+	*salida = y;
+	return 1;
+}
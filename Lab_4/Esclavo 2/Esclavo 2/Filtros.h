@@ -0,0 +1,52 @@
+/*
+ * Filtros.h
+ *
+ * Created: 21/08/2025 07:35:02
+ *  Author: valen
+ */ 
+
+
+#ifndef FILTROS_H_
+#define FILTROS_H_
+
+#include <stdint.h>
+
+// Filtros de enteros sin memoria dinamica que se aplican muestra por muestra.
+// La entrada es una lectura en escala de 10 bits (0-1023).
+// Costo aproximado por muestra con -Os (ciclos de CPU, sin contar la llamada):
+//   FILTRO_NINGUNO        ~10
+//   FILTRO_PROMEDIO       ~45   suma acumulada: resta la muestra que sale, suma la que entra
+//   FILTRO_EXPONENCIAL    ~30 + 8 por bit de parametro (desplazamientos de 16 bits)
+//   FILTRO_MEDIANA        ~40 (3 muestras) / ~150 (5 muestras)
+//   FILTRO_SOBREMUESTREO  ~20 por muestra acumulada + ~30 al decimar
+#define FILTRO_NINGUNO			0
+#define FILTRO_PROMEDIO			1	// Promedio movil de 2^parametro muestras (parametro 1-4)
+#define FILTRO_EXPONENCIAL		2	// y += (x - y) / 2^parametro (parametro 1-6)
+#define FILTRO_MEDIANA			3	// Mediana de 3 o 5 muestras (parametro 3 o 5)
+#define FILTRO_SOBREMUESTREO	4	// Suma 4^parametro muestras y desplaza parametro bits:
+									// 11 bits (parametro 1) o 12 bits (parametro 2)
+
+#define FILTRO_VENTANA_MAX		16
+
+// Configuracion inicial (se puede cambiar con -D al compilar o por I2C)
+#ifndef FILTRO_DEFECTO
+#define FILTRO_DEFECTO			FILTRO_NINGUNO
+#endif
+#ifndef FILTRO_PARAM_DEFECTO
+#define FILTRO_PARAM_DEFECTO	0
+#endif
+#ifndef FILTRO_DECIMACION_DEFECTO
+#define FILTRO_DECIMACION_DEFECTO	1
+#endif
+
+// Selecciona el filtro y reinicia su estado.
+// decimacion: se entrega 1 de cada "decimacion" salidas del filtro (0 y 1 = todas)
+void Filtro_Config(uint8_t tipo, uint8_t parametro, uint8_t decimacion);
+
+// Procesa una muestra; devuelve 1 y escribe *salida cuando hay un valor nuevo
+uint8_t Filtro_Procesar(uint16_t muestra, uint16_t *salida);
+
+// Resolucion de la salida en bits (10, 11 o 12)
+uint8_t Filtro_Bits(void);
+
+#endif /* FILTROS_H_ */
@@ -0,0 +1,159 @@
+/*
+ * Muestreo.c
+ *
+ * Created: 03/09/2025 08:22:17
+ *  Author: valen
+ */ 
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "ADC.h"
+#include "Muestreo.h"
+#include "Timer.h"
+
+#define MUESTREO_MASCARA (MUESTREO_COLA - 1)
+
+typedef struct
+{
+	uint16_t valor;
+	uint32_t tiempo;
+} Muestra;
+
+// Cola: la ISR del ADC escribe en cabeza, el programa principal lee en cola
+static volatile Muestra muestras[MUESTREO_COLA];
+static volatile uint8_t cabeza = 0;
+static volatile uint8_t cola = 0;
+
+static uint8_t rapido = 0;				// Perfil rapido: solo ADCH
+static uint16_t periodo = 0;			// Cuentas del Timer1 por muestra
+static volatile uint8_t disparos = 0;	// Comparaciones B del Timer1 (modulo 256)
+static uint8_t conversiones = 0;		// Conversiones atendidas (modulo 256)
+static volatile MuestreoCalidad calidad;
+
+uint16_t Muestreo_Iniciar(uint8_t canal, uint16_t hz)
+{
+	uint16_t tope;
+	uint16_t maximo;
+
+	// Un disparo que llega antes de que termine la conversin anterior se
+	// pierde: la tasa mxima depende del reloj del ADC de cada perfil
+	rapido = (ADC_perfil() == ADC_PERFIL_RAPIDO);
+	maximo = rapido ? MUESTREO_HZ_MAX : MUESTREO_HZ_MAX_PRECISION;
+	if (hz < MUESTREO_HZ_MIN) hz = MUESTREO_HZ_MIN;
+	if (hz > maximo) hz = maximo;
+	tope = (MUESTREO_RELOJ + hz / 2) / hz - 1;
+	periodo = tope + 1;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		cabeza = 0;
+		cola = 0;
+		disparos = 0;
+		conversiones = 0;
+		calidad.perdidas = 0;
+		calidad.tardias = 0;
+		calidad.latenciaMin = 0xFFFF;
+		calidad.latenciaMax = 0;
+	}
+
+	ADMUX = (ADMUX & 0xF0) | (canal & 0x07);
+
+	TCCR1B = 0;								// Timer detenido mientras se configura
+	TCCR1A = 0;
+	TCNT1 = 0;
+	ICR1 = tope;							// Perodo = (tope + 1) * 0.5 us
+	OCR1B = tope;							// El disparo es al llegar al tope
+	TIFR1 = (1<<OCF1B);
+	TIMSK1 |= (1<<OCIE1B);					// Cuenta de disparos (y limpia OCF1B para el siguiente)
+
+	ADCSRB = (ADCSRB & 0xF8) | (1<<ADTS2) | (1<<ADTS0);	// Disparo: comparacin B del Timer1
+	ADCSRA |= (1<<ADATE) | (1<<ADIE) | (1<<ADIF);		// (escribir ADIF en 1 lo limpia)
+
+	TCCR1B = (1<<WGM13) | (1<<WGM12) | (1<<CS11);		// CTC con tope en ICR1, prescaler 8
+
+	return (uint16_t)(MUESTREO_RELOJ / (tope + 1UL));
+}
+
+void Muestreo_Detener(void)
+{
+	TCCR1B = 0;
+	TIMSK1 &= ~(1<<OCIE1B);
+	ADCSRA &= ~((1<<ADATE) | (1<<ADIE));
+	while (ADCSRA & (1<<ADSC));				// Termina la conversin en curso
+}
+
+uint8_t Muestreo_Leer(uint16_t *valor, uint32_t *tiempo)
+{
+	uint8_t c = cola;
+
+	if (c == cabeza)
+	{
+		return 0;
+	}
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*valor = muestras[c].valor;
+		*tiempo = muestras[c].tiempo;
+	}
+	cola = (c + 1) & MUESTREO_MASCARA;
+	return 1;
+}
+
+void Muestreo_Calidad(MuestreoCalidad *c)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		c->perdidas = calidad.perdidas;
+		c->tardias = calidad.tardias;
+		c->latenciaMin = calidad.latenciaMin;
+		c->latenciaMax = calidad.latenciaMax;
+		calidad.latenciaMin = 0xFFFF;
+		calidad.latenciaMax = 0;
+	}
+}
+
+// El vector solo cuenta: al atenderlo se limpia OCF1B y el siguiente flanco
+// de la comparacin puede volver a disparar el ADC
+ISR(TIMER1_COMPB_vect)
+{
+	disparos++;
+}
+
+ISR(ADC_vect)
+{
+	uint16_t latencia = TCNT1;				// El Timer1 volvi a 0 justo despus del disparo
+	uint16_t valor = rapido ? (uint16_t)ADCH << 2 : ADC;
+	uint8_t enCurso = (ADCSRA & (1<<ADSC)) != 0;	// Ya empez la conversin siguiente
+	uint8_t c = cabeza;
+	int8_t faltan;
+
+	conversiones++;
+	if (enCurso)
+	{
+		calidad.tardias++;					// TCNT1 ya dio la vuelta: no entra en el jitter
+		latencia += periodo;
+	}
+	else
+	{
+		if (latencia < calidad.latenciaMin) calidad.latenciaMin = latencia;
+		if (latencia > calidad.latenciaMax) calidad.latenciaMax = latencia;
+	}
+
+	// Disparos sin conversin atendida (dos conversiones con una sola ISR)
+	faltan = (int8_t)(disparos - conversiones - enCurso);
+	if (faltan > 0)
+	{
+		calidad.perdidas += faltan;
+		conversiones += faltan;
+	}
+
+	if (((c + 1) & MUESTREO_MASCARA) == cola)
+	{
+		calidad.perdidas++;					// El programa principal no alcanza a vaciar la cola
+		return;
+	}
+	muestras[c].valor = valor;
+	muestras[c].tiempo = Timer_Red() - (latencia >> 1);	// El muestreo es en el disparo
+	cabeza = (c + 1) & MUESTREO_MASCARA;
+}
@@ -0,0 +1,62 @@
+/*
+ * Muestreo.h
+ *
+ * Created: 03/09/2025 08:22:41
+ *  Author: valen
+ */ 
+
+
+#ifndef MUESTREO_H_
+#define MUESTREO_H_
+
+#include <stdint.h>
+
+// Muestreo a tasa fija: el Timer1 (CTC con tope en ICR1, prescaler 8) dispara
+// cada conversion del ADC por su comparacion B (ADTS = 101), sin depender de
+// lo que este haciendo la CPU. La ISR del ADC guarda cada muestra con su
+// tiempo de red en una cola que el programa principal vacia.
+//
+// Calidad del muestreo:
+//   perdidas   conversiones que no llegaron a la cola (disparo sin conversion
+//              o cola llena)
+//   tardias    la ISR del ADC corrio despues del disparo siguiente
+//   latencia   cuentas del Timer1 (0.5 us) desde el disparo hasta la ISR;
+//              incluye la conversion (13.5 ciclos del ADC). Su variacion
+//              (maximo - minimo) es el jitter de la ISR
+#define MUESTREO_RELOJ		2000000UL	// 16 MHz / 8
+#define MUESTREO_HZ_MIN		31			// Tope de 16 bits
+#define MUESTREO_HZ_MAX		10000		// Perfil rapido: limite de la ISR y del programa principal
+#define MUESTREO_HZ_MAX_PRECISION 9000	// Perfil de precision: la conversion disparada dura
+										// 13.5 ciclos de 125 kHz = 108 us (~9.2 kHz)
+#define MUESTREO_COLA		16			// Muestras esperando al programa principal (potencia de 2)
+
+// Tasa al encender (se puede cambiar con -D al compilar o por I2C)
+#ifndef MUESTREO_HZ_DEFECTO
+#define MUESTREO_HZ_DEFECTO	1000
+#endif
+
+typedef struct
+{
+	uint16_t perdidas;		// Desde Muestreo_Iniciar
+	uint16_t tardias;		// Desde Muestreo_Iniciar
+	uint16_t latenciaMin;	// Desde la consulta anterior
+	uint16_t latenciaMax;	// Desde la consulta anterior
+} MuestreoCalidad;
+
+// Arranca el muestreo de un canal; devuelve la tasa real en Hz (la pedida se
+// limita a MUESTREO_HZ_MIN - MUESTREO_HZ_MAX, o MUESTREO_HZ_MAX_PRECISION en
+// el perfil de precision, y se redondea al tope del Timer1).
+// Se debe llamar despues de ADC_config (toma el perfil activo)
+uint16_t Muestreo_Iniciar(uint8_t canal, uint16_t hz);
+
+// Detiene el Timer1 y el disparo automatico (antes de ADC_config)
+void Muestreo_Detener(void);
+
+// Saca la muestra mas vieja de la cola (escala de 10 bits) y el tiempo de red
+// del disparo; devuelve 0 si la cola esta vacia
+uint8_t Muestreo_Leer(uint16_t *valor, uint32_t *tiempo);
+
+// Copia la calidad del muestreo y reinicia la ventana de latencia
+void Muestreo_Calidad(MuestreoCalidad *calidad);
+
+#endif /* MUESTREO_H_ */
@@ -0,0 +1,66 @@
+/*
+ * Pila.c
+ *
+ * Created: 05/09/2025 07:40:52
+ *  Author: valen
+ */ 
+
+#include "Pila.h"
+
+extern uint8_t _end;	// Final de .bss (lo define el enlazador)
+extern uint8_t __stack;	// Tope de la pila (RAMEND)
+
+// Byte usado ms profundo conocido (0 = todava no se midi)
+static uint8_t *fondo = 0;
+
+// Sin prlogo ni retorno: el cdigo de .init1 sigue de largo hacia .init2.
+// Todava no hay pila ni __zero_reg__, por eso el bucle est en ensamblador
+void Pila_Pintar(void) __attribute__((naked, used, section(".init1")));
+
+void Pila_Pintar(void)
+{
+	__asm__ volatile (
+		"	ldi r30, lo8(_end)		\n"
+		"	ldi r31, hi8(_end)		\n"
+		"	ldi r24, %0				\n"
+		"	ldi r25, hi8(__stack)	\n"
+		"	rjmp 2f					\n"
+		"1:	st Z+, r24				\n"
+		"2:	cpi r30, lo8(__stack)	\n"
+		"	cpc r31, r25			\n"
+		"	brlo 1b					\n"
+		"	breq 1b					\n"
+		: : "M" (PILA_PATRON)
+	);
+}
+
+uint16_t Pila_Estatica(void)
+{
+	return (uint16_t)&_end - RAMSTART;
+}
+
+uint16_t Pila_Libre(void)
+{
+	uint8_t *p = fondo ? fondo : &__stack + 1;
+	uint8_t i;
+
+	// Se baja desde el fondo anterior mientras haya bytes escritos. Un dato de
+	// la pila puede valer lo mismo que el patrn, por eso solo PILA_MARGEN
+	// bytes seguidos con el patrn indican que de ah para abajo no se us
+	while (p > &_end)
+	{
+		for (i = 1; i <= PILA_MARGEN && p - i >= &_end && p[-i] == PILA_PATRON; i++);
+		if (i > PILA_MARGEN || p - i < &_end)
+		{
+			break;
+		}
+		p -= i; // p[-i] fue escrito: nuevo fondo
+	}
+	fondo = p;
+	return p - &_end;
+}
+
+uint16_t Pila_Maxima(void)
+{
+	return ((uint16_t)&__stack + 1 - (uint16_t)&_end) - Pila_Libre();
+}
@@ -0,0 +1,99 @@
+/*
+ * Registros.h
+ *
+ * Created: 20/08/2025 08:41:12
+ *  Author: valen
+ */ 
+
+
+#ifndef REGISTROS_H_
+#define REGISTROS_H_
+
+#include <stdint.h>
+
+// Mapa de registros del esclavo ADC (0x40)
+//
+// Escritura: [SLA+W][registro][datos...]  -> el puntero queda en "registro" y
+//            los datos se guardan con autoincremento (solo en configuracion).
+//            Un primer byte >= REG_COMANDOS es un comando ('L', 'S', ...).
+// Lectura:   [SLA+R][datos...]            -> se leen hasta REG_LECTURA_MAX bytes
+//            desde el puntero, copiados todos juntos al inicio de la lectura,
+//            por lo que los valores de varios bytes llegan completos.
+// Los valores de varios bytes van en little-endian.
+#define NUM_REGISTROS		0x40
+#define REG_COMANDOS		0x40
+#define REG_LECTURA_MAX		16
+
+// Bloque de datos (solo lectura, congelados por el ultimo latch)
+#define REG_ADC8			0x00	// u8  lectura en 8 bits (registro por defecto)
+#define REG_ADC16			0x01	// u16 lectura filtrada con la resolucion de REG_RESOLUCION
+#define REG_RESOLUCION		0x03	// u8  bits validos en REG_ADC16 (10 a 12)
+#define REG_TS_MUESTRA		0x04	// u32 tiempo de red (us) en que se tomo la muestra publicada
+#define REG_TS_LATCH		0x08	// u32 tiempo de red (us) del latch
+
+// Cola de eventos de umbral (se actualiza sola, no depende del latch)
+#define REG_EVENTOS			0x0C	// u8  eventos pendientes
+#define REG_EVENTO			0x0D	// 7 bytes, evento mas viejo: tipo (u8), valor (u16), tiempo de red (u32)
+									//     se quita de la cola al leer los 8 bytes desde REG_EVENTOS
+#define REG_EVENTOS_PERDIDOS 0x14	// u8  eventos perdidos por tener la cola llena
+
+// Calidad del muestreo a tasa fija (congelada por el latch, ver Muestreo.h)
+#define REG_PERDIDAS		0x15	// u16 conversiones perdidas desde el ultimo cambio de configuracion
+#define REG_TARDIAS			0x17	// u16 ISR del ADC atendidas despues del disparo siguiente
+#define REG_JITTER			0x19	// u16 latencia maxima - minima desde el latch anterior (0.5 us)
+#define REG_LATENCIA_MAX	0x1B	// u16 latencia maxima disparo-ISR desde el latch anterior (0.5 us)
+#define REG_MUESTREO_REAL	0x1D	// u16 tasa de muestreo lograda con REG_MUESTREO_HZ (Hz, al aplicar la configuracion)
+
+// Bloque de configuracion (lectura/escritura); se aplica entero al terminar
+// la escritura (STOP o START repetido), no byte por byte
+#define REG_CONFIG_INICIO	0x20
+#define REG_PERFIL			0x20	// u8  ADC_PERFIL_PRECISION / ADC_PERFIL_RAPIDO
+#define REG_REFERENCIA		0x21	// u8  ADC_REF_AREF / ADC_REF_AVCC / ADC_REF_INTERNA
+#define REG_FILTRO			0x22	// u8  FILTRO_NINGUNO ... FILTRO_SOBREMUESTREO
+#define REG_FILTRO_PARAM	0x23	// u8  parametro del filtro (ver Filtros.h)
+#define REG_DECIMACION		0x24	// u8  se publica 1 de cada N salidas del filtro
+#define REG_UMBRAL_BAJO		0x25	// u16 ventana de comparacion, en la escala de REG_ADC16
+#define REG_UMBRAL_ALTO		0x27	// u16
+#define REG_HISTERESIS		0x29	// u8  cuentas para salir de la zona baja o alta
+#define REG_TASA_MAX		0x2A	// u16 cambio maximo por intervalo (0 = sin limite)
+#define REG_TASA_MS			0x2C	// u8  intervalo del limite de cambio (ms)
+#define REG_MUESTREO_HZ		0x2D	// u16 tasa de muestreo pedida (31 a 10000 Hz, 9000 en precision)
+#define REG_CONFIG_FIN		0x30
+
+// Bloque de diagnostico (traza del TWI, ver Traza.h)
+#define REG_TRAZA_CUENTA	0x30	// u8  eventos guardados (0 si no se compilo con TRAZA_TWI)
+#define REG_TRAZA_SEL		0x31	// u8  escribir n congela la traza y publica el evento n (TRAZA_REANUDAR la reanuda)
+#define REG_TRAZA_DATOS		0x32	// 4 bytes del evento: marca de tiempo (u16), estado, dato
+
+// Uso de la SRAM (ver Pila.h), medido por el programa principal despues de cada latch
+#define REG_RAM_ESTATICA	0x36	// u16 bytes de .data + .bss
+#define REG_PILA_MAXIMA		0x38	// u16 maxima profundidad de la pila desde el reset
+#define REG_PILA_LIBRE		0x3A	// u16 bytes que la pila nunca alcanzo (margen minimo)
+
+// Reloj de red (ver Timer.h), actualizado en cada sincronizacion
+#define REG_DERIVA			0x3C	// i16 correccion de frecuencia en decimas de ppm
+
+extern volatile uint8_t registros[NUM_REGISTROS];
+
+// Escritura de valores de varios bytes en el mapa
+// (desde el programa principal se debe llamar dentro de un ATOMIC_BLOCK)
+static inline void Reg_Escribir16(uint8_t reg, uint16_t valor)
+{
+	registros[reg] = valor;
+	registros[reg + 1] = valor >> 8;
+}
+
+static inline void Reg_Escribir32(uint8_t reg, uint32_t valor)
+{
+	registros[reg] = valor;
+	registros[reg + 1] = valor >> 8;
+	registros[reg + 2] = valor >> 16;
+	registros[reg + 3] = valor >> 24;
+}
+
+static inline uint16_t Reg_Leer16(uint8_t reg)
+{
+	return registros[reg] | ((uint16_t)registros[reg + 1] << 8);
+}
+
+#endif /* REGISTROS_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Traza.h
+ *
+ * Created: 27/08/2025 07:55:19
+ *  Author: valen
+ */ 
+
+
+#ifndef TRAZA_H_
+#define TRAZA_H_
+
+#include <stdint.h>
+#include "Timer.h"
+
+// Registro de eventos del TWI en un buffer circular en RAM.
+// Solo se compila si TRAZA_TWI esta definido (en los proyectos, en la
+// configuracion Debug); si no, TRAZA() no genera codigo.
+// Cada evento guarda ~20 ciclos de trabajo: marca de tiempo, estado y dato.
+// Traza_Registrar no es reentrante: llamarla desde un solo contexto
+// (la ISR del TWI en los esclavos, el programa principal en el Maestro).
+
+#define TRAZA_TAM		32		// Eventos guardados (potencia de 2)
+
+// Estados propios (los del TWI siempre tienen los bits 2..0 en 0)
+#define TRAZA_STOP		0x01	// El maestro genero STOP
+
+// Valor de seleccion que reanuda el registro (cualquier otro lo congela)
+#define TRAZA_REANUDAR	0xFF
+
+typedef struct
+{
+	uint16_t tiempo;	// Timer_Marca(): ms mod 256 en el byte alto, cuentas de 4 us en el bajo
+	uint8_t estado;		// TWSR & 0xF8 o un estado propio
+	uint8_t dato;		// TWDR en el momento del evento
+} TrazaEvento;
+
+#ifdef TRAZA_TWI
+
+extern TrazaEvento trazaBuffer[TRAZA_TAM];
+extern uint8_t trazaIndice;		// Proxima posicion a escribir
+extern uint8_t trazaCuenta;		// Eventos validos (hasta TRAZA_TAM)
+extern volatile uint8_t trazaActiva;
+
+static inline void Traza_Registrar(uint8_t estado, uint8_t dato)
+{
+	if (trazaActiva)
+	{
+		TrazaEvento *e = &trazaBuffer[trazaIndice];
+		e->tiempo = Timer_Marca();
+		e->estado = estado;
+		e->dato = dato;
+		trazaIndice = (trazaIndice + 1) & (TRAZA_TAM - 1);
+		if (trazaCuenta < TRAZA_TAM) trazaCuenta++;
+	}
+}
+
+#define TRAZA(estado, dato) Traza_Registrar((estado), (dato))
+
+#else
+
+#define TRAZA(estado, dato) do { } while (0)
+
+#endif
+
+// Congela (1) o reanuda (0) el registro para poder volcarlo sin mezclar eventos
+void Traza_Congelar(uint8_t congelar);
+
+// Eventos guardados (0 si la traza no esta compilada)
+uint8_t Traza_Cuenta(void);
+
+// Copia el evento n, contando desde el mas antiguo, en 4 bytes:
+// tiempo (little-endian), estado, dato. Devuelve 0 si n no existe.
+uint8_t Traza_Leer(uint8_t n, uint8_t *destino);
+
+#endif /* TRAZA_H_ */
@@ -9,32 +9,192 @@
 
 #include <avr/io.h>         // Librera base para registros del AVR
 #include <avr/interrupt.h>  // Librera para manejo de interrupciones
+#include <util/atomic.h>    // Librera para accesos atmicos a variables compartidas con ISR
 #include <util/delay.h>     // Librera para retardos
 
 #include "ADC.h"            // Librera personalizada para manejar el ADC
+#include "Filtros.h"        // Filtros de enteros aplicados a cada muestra
+#include "Eventos.h"        // Umbrales, histresis y lmite de cambio con cola de eventos
+#include "Muestreo.h"       // Conversiones disparadas por el Timer1 a tasa fija
+#include "Pila.h"           // Uso mximo de la pila y margen de SRAM
 #include "I2C.h"            // Librera personalizada para manejar el I2C
+#include "Registros.h"      // Mapa de registros accesible por I2C
+#include "Timer.h"          // Base de tiempo (Timer2) para las marcas de la traza
+#include "Traza.h"          // Traza opcional de los estados del TWI (TRAZA_TWI)
 
 // Direccin I2C del esclavo
 #define SlaveAddress 0x40
 
+// Canal del ADC que se muestrea
+#define CANAL_ADC 6
+
 // Variables globales
 uint8_t buffer = 0;         // Almacena el dato recibido por I2C (comando del maestro)
-uint16_t valueADC = 0;      // Valor de 10 bits del ADC (pero se usar solo 8 bits al enviar)
+volatile uint16_t valueADC = 0; // Valor filtrado del ADC (10 a 12 bits; en REG_ADC8 se envan solo 8 bits)
+volatile uint8_t bitsADC = 10;  // Resolucin actual de valueADC
+volatile uint32_t tiempoADC = 0; // Tiempo de red (us) de la muestra que produjo valueADC
+
+// Registros accesibles por I2C y estado de la transaccin en curso
+volatile uint8_t registros[NUM_REGISTROS];
+uint8_t puntero = REG_ADC8;             // Registro de la prxima lectura o escritura
+uint8_t primerDato = 0;                 // 1 = el prximo byte recibido es registro o comando
+uint8_t txBuffer[REG_LECTURA_MAX];      // Copia de los registros que se estn enviando
+uint8_t txIndice = 0;
+uint8_t leyendoEvento = 0;              // La lectura en curso empez en REG_EVENTOS
+uint8_t configEscrita = 0;              // La escritura en curso modific el bloque de configuracin
+volatile uint8_t configPendiente = 0;   // El maestro termin de escribir en el bloque de configuracin
+volatile uint8_t memoriaPendiente = 1;  // Hubo un latch: volver a medir la pila
+
+// Sincronizacin del reloj de red (llamada general 'T' + 4 bytes de tiempo)
+uint32_t sincLocal;                     // micros() al recibir el comando
+uint32_t sincTiempo;                    // Tiempo del maestro que se va armando
+uint8_t sincIndice = 4;                 // Bytes de tiempo recibidos (4 = sin sincronizacin en curso)
+
+// Congela la lectura actual en el bloque de datos (se llama desde la ISR)
+static inline void latchDatos(void)
+{
+	registros[REG_ADC8] = valueADC >> (bitsADC - 8);
+	Reg_Escribir16(REG_ADC16, valueADC);
+	registros[REG_RESOLUCION] = bitsADC;
+	Reg_Escribir32(REG_TS_MUESTRA, tiempoADC);
+	Reg_Escribir32(REG_TS_LATCH, Timer_Red());
+
+	MuestreoCalidad calidad;
+	Muestreo_Calidad(&calidad); // Reinicia la ventana de latencia
+	Reg_Escribir16(REG_PERDIDAS, calidad.perdidas);
+	Reg_Escribir16(REG_TARDIAS, calidad.tardias);
+	if (calidad.latenciaMax)
+	{
+		Reg_Escribir16(REG_JITTER, calidad.latenciaMax - calidad.latenciaMin);
+	}
+	else
+	{
+		Reg_Escribir16(REG_JITTER, 0); // Ninguna muestra a tiempo desde el latch anterior
+	}
+	Reg_Escribir16(REG_LATENCIA_MAX, calidad.latenciaMax);
+	puntero = REG_ADC8; // La siguiente lectura simple devuelve el dato en 8 bits
+	memoriaPendiente = 1;
+}
+
+// Publica el uso de la pila (desde el programa principal: Pila_Libre no es reentrante)
+static inline void publicarMemoria(void)
+{
+	uint16_t libre = Pila_Libre();
+	uint16_t maxima = Pila_Maxima();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Reg_Escribir16(REG_PILA_MAXIMA, maxima);
+		Reg_Escribir16(REG_PILA_LIBRE, libre);
+	}
+}
+
+// Publica la cola de eventos en el mapa (desde el programa principal se debe
+// llamar dentro de un ATOMIC_BLOCK)
+static inline void publicarEventos(void)
+{
+	uint8_t evento[EVENTO_BYTES];
+
+	Eventos_Primero(evento);
+	registros[REG_EVENTOS] = Eventos_Pendientes();
+	for (uint8_t i = 0; i < EVENTO_BYTES; i++)
+	{
+		registros[REG_EVENTO + i] = evento[i];
+	}
+	registros[REG_EVENTOS_PERDIDOS] = Eventos_Perdidos();
+}
+
+// Publica el evento n de la traza en REG_TRAZA_DATOS (se llama desde la ISR)
+static inline void seleccionarTraza(uint8_t n)
+{
+	uint8_t evento[4] = {0, 0, 0, 0};
+
+	Traza_Congelar(n != TRAZA_REANUDAR); // Congelada mientras el maestro la lee
+	Traza_Leer(n, evento);
+	registros[REG_TRAZA_CUENTA] = Traza_Cuenta();
+	registros[REG_TRAZA_SEL] = n;
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		registros[REG_TRAZA_DATOS + i] = evento[i];
+	}
+}
 
 //******************************************************************
 
 int main(void)
 {
 	ADC_init();                  // Inicializa el mdulo ADC
+	registros[REG_PERFIL] = ADC_PERFIL_DEFECTO;
+	registros[REG_REFERENCIA] = ADC_REF_DEFECTO;
+	Filtro_Config(FILTRO_DEFECTO, FILTRO_PARAM_DEFECTO, FILTRO_DECIMACION_DEFECTO);
+	registros[REG_FILTRO] = FILTRO_DEFECTO;
+	registros[REG_FILTRO_PARAM] = FILTRO_PARAM_DEFECTO;
+	registros[REG_DECIMACION] = FILTRO_DECIMACION_DEFECTO;
+	Reg_Escribir16(REG_UMBRAL_BAJO, EVENTOS_BAJO_DEFECTO);
+	Reg_Escribir16(REG_UMBRAL_ALTO, EVENTOS_ALTO_DEFECTO);
+	registros[REG_HISTERESIS] = EVENTOS_HISTERESIS_DEFECTO;
+	Reg_Escribir16(REG_TASA_MAX, EVENTOS_TASA_DEFECTO);
+	registros[REG_TASA_MS] = EVENTOS_TASA_MS_DEFECTO;
+	Reg_Escribir16(REG_MUESTREO_HZ, MUESTREO_HZ_DEFECTO);
+	Reg_Escribir16(REG_MUESTREO_REAL, Muestreo_Iniciar(CANAL_ADC, MUESTREO_HZ_DEFECTO));
+	Reg_Escribir16(REG_RAM_ESTATICA, Pila_Estatica());
 	//UART_init();              // UART comentado (no se usa en este programa)
+	Timer_init();                // Reloj de red y marcas de tiempo de la traza del TWI
 	I2C_Slave_Init(SlaveAddress); // Inicializa esclavo I2C con direccin 0x40
 	
 	sei(); // Habilita interrupciones globales
 
 	while (1) 
 	{
-		// Lee el valor del canal ADC 6, y lo reduce de 10 bits a 8 bits (divisin por 4)
-		valueADC = ADC_read(6) >> 2;
+		// El maestro cambi el perfil, la referencia, el filtro o la tasa por I2C
+		if (configPendiente)
+		{
+			configPendiente = 0;
+			Muestreo_Detener(); // El ADC no se reconfigura con el disparo automtico activo
+			ADC_config(registros[REG_PERFIL], registros[REG_REFERENCIA]);
+			registros[REG_PERFIL] = ADC_perfil(); // Un perfil invlido queda en precisin
+			registros[REG_REFERENCIA] = ADC_referencia(); // Una referencia invlida queda en la de defecto
+			Filtro_Config(registros[REG_FILTRO], registros[REG_FILTRO_PARAM], registros[REG_DECIMACION]);
+			Eventos_Config(Reg_Leer16(REG_UMBRAL_BAJO), Reg_Leer16(REG_UMBRAL_ALTO), registros[REG_HISTERESIS],
+			               Reg_Leer16(REG_TASA_MAX), registros[REG_TASA_MS]);
+			uint16_t hz = Muestreo_Iniciar(CANAL_ADC, Reg_Leer16(REG_MUESTREO_HZ));
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				// La tasa pedida queda como la escribi el maestro
+				Reg_Escribir16(REG_MUESTREO_REAL, hz); // Tasa real (limitada y redondeada)
+			}
+		}
+
+		// Filtra las muestras del canal ADC 6 (escala de 10 bits en ambos perfiles)
+		// que dej la ISR del ADC; el tiempo de cada una es el de su disparo
+		uint16_t lectura;
+		uint16_t muestra;
+		uint32_t tiempo;
+		if (Muestreo_Leer(&muestra, &tiempo) && Filtro_Procesar(muestra, &lectura))
+		{
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				valueADC = lectura; // La ISR de TWI puede congelar el valor en cualquier momento
+				bitsADC = Filtro_Bits();
+				tiempoADC = tiempo;
+			}
+
+			// Solo los cruces de umbral generan eventos para el maestro
+			if (Eventos_Evaluar(lectura, tiempo))
+			{
+				ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+				{
+					publicarEventos();
+				}
+			}
+		}
+
+		// Uso de la pila hasta el ltimo latch, para la prxima lectura del maestro
+		if (memoriaPendiente)
+		{
+			memoriaPendiente = 0;
+			publicarMemoria();
+		}
 
 		// El buffer acta como bandera para saber si el maestro pidi el dato ('L')
 		if (buffer == 'L')
@@ -47,36 +207,129 @@ int main(void)
 }
 
 // Rutina de interrupcin del perifrico I2C (TWI)
-ISR(TWI_vect)
+ISR(TWI_VECTOR)
 {
 	uint8_t estado;
-	estado = TWSR & 0xFC; // Mscara para obtener cdigo de estado TWI (se ignoran bits de control)
+	estado = TWI_Estado(); // Mscara para obtener cdigo de estado TWI (se ignoran bits de control)
+	TRAZA(estado, TWI_TWDR);  // Solo si se compil con TRAZA_TWI (pocos ciclos)
 
 	switch (estado)
 	{
 		// El maestro inici comunicacin con esclavo (SLA+W)
-		case 0x60: // Direccin propia + escritura
-		case 0x70: // Direccin general + escritura
-			TWCR |= (1 << TWINT); // Limpia bandera para seguir escuchando
+		case TWI_SR_SLA_ACK: // Direccin propia + escritura
+		case TWI_SR_GENERAL_ACK: // Direccin general + escritura
+			primerDato = 1;       // El primer byte ser un registro o un comando
+			TWI_TWCR |= (1 << TWINT); // Limpia bandera para seguir escuchando
 			break;
 
-		// El maestro envi un dato (comando)
-		case 0x80: // Direccin propia
-		case 0x90: // Direccin general
-			buffer = TWDR;       // Guarda el dato recibido (espera 'L')
-			TWCR |= (1 << TWINT); // Limpia bandera
+		// El maestro envi un dato (registro, comando o valor de configuracin)
+		case TWI_SR_DATO_ACK: // Direccin propia
+			buffer = TWI_TWDR;       // Guarda el dato recibido
+			if (primerDato)
+			{
+				primerDato = 0;
+				if (buffer >= REG_COMANDOS)
+				{
+					if (buffer == 'L')
+					{
+						latchDatos(); // Congela la lectura para la prxima peticin
+					}
+				}
+				else
+				{
+					puntero = buffer; // Seleccin de registro
+				}
+			}
+			else if (puntero >= REG_CONFIG_INICIO && puntero < REG_CONFIG_FIN)
+			{
+				registros[puntero++] = buffer; // Escritura con autoincremento
+				configEscrita = 1; // Se aplica al terminar: un u16 llega en dos bytes
+			}
+			else if (puntero == REG_TRAZA_SEL)
+			{
+				seleccionarTraza(buffer);
+			}
+			TWI_TWCR |= (1 << TWINT); // Limpia bandera
+			break;
+
+		case TWI_SR_GENERAL_DATO_ACK: // Direccin general
+			buffer = TWI_TWDR;
+			if (primerDato)
+			{
+				primerDato = 0;
+				sincIndice = 4;
+				if (buffer == I2C_CMD_LATCH)
+				{
+					latchDatos(); // Muestreo sincronizado con los dems esclavos
+				}
+				else if (buffer == I2C_CMD_TIEMPO)
+				{
+					// El maestro toma su tiempo al recibir este mismo ACK
+					sincLocal = micros();
+					sincTiempo = 0;
+					sincIndice = 0;
+				}
+			}
+			else if (sincIndice < 4)
+			{
+				sincTiempo |= (uint32_t)buffer << (8 * sincIndice);
+				if (++sincIndice == 4)
+				{
+					Timer_Sincronizar(sincLocal, sincTiempo);
+					Reg_Escribir16(REG_DERIVA, Timer_Deriva());
+				}
+			}
+			TWI_TWCR |= (1 << TWINT);
+			break;
+
+		// Fin de la escritura (STOP o START repetido)
+		case TWI_SR_STOP:
+			if (configEscrita)
+			{
+				configEscrita = 0;
+				configPendiente = 1;
+			}
+			TWI_TWCR |= (1 << TWINT);
 			break;
 
 		// El maestro solicita datos (SLA+R)
-		case 0xA8: // Direccin propia + lectura
-		case 0xB8: // Maestro ya recibi un byte y quiere otro
-			TWDR = valueADC;      // Se carga el dato del ADC en el registro de transmisin
-			TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA); // Se prepara para enviar y seguir escuchando
+		case TWI_ST_SLA_ACK: // Direccin propia + lectura
+			// Se copian juntos los registros a enviar para que un valor de varios
+			// bytes no cambie a mitad de la lectura
+			for (uint8_t i = 0; i < REG_LECTURA_MAX; i++)
+			{
+				txBuffer[i] = registros[(puntero + i) & (NUM_REGISTROS - 1)];
+			}
+			txIndice = 0;
+			leyendoEvento = (puntero == REG_EVENTOS);
+			// no break: se enva el primer byte
+		case TWI_ST_DATO_ACK: // Maestro ya recibi un byte y quiere otro
+			TWI_TWDR = txBuffer[txIndice];  // Se carga el siguiente registro en el registro de transmisin
+			if (txIndice < REG_LECTURA_MAX - 1)
+			{
+				txIndice++;
+			}
+			TWI_TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA); // Se prepara para enviar y seguir escuchando
+			break;
+
+		// El maestro termin la lectura (NACK al ltimo byte)
+		case TWI_ST_DATO_NACK:
+		case TWI_ST_ULTIMO_ACK:
+			// Si ley completo el evento ms viejo, se quita de la cola. Solo si la
+			// copia enviada tena uno: un evento encolado durante la lectura no
+			// lleg al maestro y se queda para la prxima
+			if (leyendoEvento && txBuffer[0] != 0 && txIndice >= REG_EVENTO + EVENTO_BYTES - REG_EVENTOS)
+			{
+				Eventos_Sacar();
+				publicarEventos();
+			}
+			leyendoEvento = 0;
+			TWI_TWCR |= (1 << TWINT); // TWEA sigue en 1: vuelve a escuchar su direccin
 			break;
 
 		// Cualquier otro estado inesperado
 		default:
-			TWCR |= (1 << TWINT) | (1 << TWSTO); // Limpia bandera y genera condicin de parada para liberar bus
+			TWI_TWCR |= (1 << TWINT) | (1 << TWSTO); // Limpia bandera y genera condicin de parada para liberar bus
 			break;
 	}
 }
@@ -15,27 +15,27 @@ void I2C_Master_Init(unsigned long SCL_Clock, uint8_t Prescaler) {
 
     switch (Prescaler) {
         case 1:
-            TWSR0 &= ~((1 << TWPS1) | (1 << TWPS0));
+            TWI_TWSR &= ~((1 << TWPS1) | (1 << TWPS0));
             break;
         case 4:
-            TWSR0 &= ~(1 << TWPS1);
-            TWSR0 |= (1 << TWPS0);
+            TWI_TWSR &= ~(1 << TWPS1);
+            TWI_TWSR |= (1 << TWPS0);
             break;
         case 16:
-            TWSR0 &= ~(1 << TWPS0);
-            TWSR0 |= (1 << TWPS1);
+            TWI_TWSR &= ~(1 << TWPS0);
+            TWI_TWSR |= (1 << TWPS1);
             break;
         case 64:
-            TWSR0 |= (1 << TWPS1) | (1 << TWPS0);
+            TWI_TWSR |= (1 << TWPS1) | (1 << TWPS0);
             break;
 		default:
-			TWSR0 &= ~((1 << TWPS1) | (1 << TWPS0));
+			TWI_TWSR &= ~((1 << TWPS1) | (1 << TWPS0));
 			Prescaler=1;
 			break;
 
     }
-	TWBR0 = (((16000000)/SCL_Clock)-16)/(2*Prescaler); //Debe ser mayor a 10 para operar de forma estable
-	TWCR0 |= (1<<TWEN);
+	TWI_TWBR = (((16000000)/SCL_Clock)-16)/(2*Prescaler); //Debe ser mayor a 10 para operar de forma estable
+	TWI_TWCR |= (1<<TWEN);
 }
 
 //************************************************************************
@@ -44,8 +44,8 @@ void I2C_Master_Init(unsigned long SCL_Clock, uint8_t Prescaler) {
 void I2C_Master_Start(void){
     //uint8_t estado;
     
-    TWCR0 = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN); // Iniciar condicin de start
-    while(!(TWCR0 & (1<<TWINT))); // Espera a que termine la flag TWINT
+    TWI_TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN); // Iniciar condicin de start
+    TWI_Esperar(); // Espera a que termine la flag TWINT
 
 }
 
@@ -53,7 +53,7 @@ void I2C_Master_Start(void){
 // Funcion de parada de la comunicacion I2C
 //************************************************************************
 void I2C_Master_Stop(void){
-    TWCR0 = (1<<TWEN) | (1<<TWINT) | (1<<TWSTO); // Inicia el envo secuencia parada STOP
+    TWI_TWCR = (1<<TWEN) | (1<<TWINT) | (1<<TWSTO); // Inicia el envo secuencia parada STOP
 }
 
 //************************************************************************
@@ -64,15 +64,15 @@ void I2C_Master_Stop(void){
 uint8_t I2C_Master_Write(uint8_t dato){
     uint8_t estado;
 
-    TWDR0 = dato;  // Cargar el dato
-    TWCR0 = (1<<TWEN) | (1<<TWINT); // Inicia el envo
+    TWI_TWDR = dato;  // Cargar el dato
+    TWI_TWCR = (1<<TWEN) | (1<<TWINT); // Inicia el envo
 
-    while(!(TWCR0 & (1<<TWINT))); // Espera al flag TWINT
+    TWI_Esperar(); // Espera al flag TWINT
 
-    estado = TWSR0 & 0xF8; // Verificar estado
+    estado = TWI_Estado(); // Verificar estado
 
     // Verificar si se transmiti una SLA + W con ACK, SLA + R con ACK, o un Dato con ACK
-    if(estado == 0x18 || estado == 0x28 || estado == 0x40){
+    if(estado == TWI_MT_SLA_ACK || estado == TWI_MT_DATO_ACK || estado == TWI_MR_SLA_ACK){
         return 1;
     }else{
         return estado;
@@ -87,19 +87,19 @@ uint8_t I2C_Master_Read(uint8_t *buffer, uint8_t ack){
     uint8_t estado;
     
     if(ack){
-        TWCR0 |= (1<<TWEA);  // Lectura con ACK
+        TWI_TWCR |= (1<<TWEA);  // Lectura con ACK
     }else{
-        TWCR0 &= ~(1<<TWEA); // Lectura sin ACK
+        TWI_TWCR &= ~(1<<TWEA); // Lectura sin ACK
     }
 
-    TWCR0 |= (1<<TWINT); // Iniciamos la lectura
-    while(!(TWCR0 & (1<<TWINT))); // Espera al flag TWINT
+    TWI_TWCR |= (1<<TWINT); // Iniciamos la lectura
+    TWI_Esperar(); // Espera al flag TWINT
 
-    estado = TWSR0 & 0xF8; // Verificar estado
+    estado = TWI_Estado(); // Verificar estado
 
     // Verificar dato ledo con ACK o sin ACK
-    if(estado == 0x58 || estado == 0x50){
-        *buffer = TWDR0;
+    if(estado == TWI_MR_DATO_NACK || estado == TWI_MR_DATO_ACK){
+        *buffer = TWI_TWDR;
         return 1;
     }else{
         return estado;
@@ -113,9 +113,8 @@ uint8_t I2C_Master_Read(uint8_t *buffer, uint8_t ack){
 void I2C_Slave_Init(uint8_t address) {
     DDRC &= ~((1<<DDC4)|(1<<DDC5));  // Pines de I2C como entradas
 
-    TWAR0 = address << 1;  // Se asigna la direccion que tendra
-    // TWAR = (address << 1 | 0x01);  // Se asigna la direccion que tendra y habilita llamada gen
+    TWI_TWAR = (address << 1) | (1 << TWGCE);  // Se asigna la direccion que tendra y habilita llamada gen
 
     // Se habilita la interfaz, ACK automtico, se habilita la ISR
-    TWCR0 = (1<<TWEA) | (1<<TWEN) | (1<<TWIE);
+    TWI_TWCR = (1<<TWEA) | (1<<TWEN) | (1<<TWIE);
 }
\ No newline at end of file
@@ -11,6 +11,17 @@
 
 #include <avr/io.h>
 #include <stdint.h>
+#include "../../HAL/TWI.h" // Registros y estados del TWI comunes a los tres nodos
+
+// Direccion de llamada general (todos los esclavos con TWGCE la reconocen)
+#define I2C_LLAMADA_GENERAL 0x00
+
+// Comando de llamada general: cada esclavo congela (latch) su dato en el mismo instante
+#define I2C_CMD_LATCH 'S'
+
+// Comando de llamada general para sincronizar los relojes: le siguen 4 bytes con
+// el tiempo del maestro (us, little-endian) tomado al recibir el ACK del comando
+#define I2C_CMD_TIEMPO 'T'
 
 // Funcion para inicializar I2C Maestro
 void I2C_Master_Init(unsigned long SCL_Clock, uint8_t Prescaler);
@@ -0,0 +1,37 @@
+/*
+ * Pila.h
+ *
+ * Created: 05/09/2025 07:41:26
+ *  Author: valen
+ */ 
+
+
+#ifndef PILA_H_
+#define PILA_H_
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// Medicion del uso de la SRAM.
+// Antes de inicializar .data y .bss (seccion .init1) se llena todo lo que
+// queda libre, desde el final de .bss hasta RAMEND, con PILA_PATRON. La pila
+// crece hacia abajo desde RAMEND, asi que los bytes que todavia tienen el
+// patron nunca se usaron: el limite entre ambas zonas es la maxima
+// profundidad alcanzada desde el reset. No se usa malloc, por lo que ese
+// espacio entre .bss y la pila es todo el margen que queda.
+
+#define PILA_PATRON		0xC5
+#define PILA_MARGEN		4		// Bytes seguidos con el patron que marcan la zona sin usar
+
+// Bytes de SRAM ocupados por .data y .bss (fijos al compilar)
+uint16_t Pila_Estatica(void);
+
+// Bytes que la pila nunca alcanzo desde el reset (el margen minimo).
+// Solo revisa lo que crecio la pila desde la llamada anterior, asi que es
+// rapida; no es reentrante: llamarla desde el programa principal
+uint16_t Pila_Libre(void);
+
+// Maxima profundidad de la pila desde el reset (SRAM - estatica - libre)
+uint16_t Pila_Maxima(void);
+
+#endif /* PILA_H_ */
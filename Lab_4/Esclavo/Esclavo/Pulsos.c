@@ -0,0 +1,203 @@
+/*
+ * Pulsos.c
+ *
+ * Created: 22/08/2025 08:31:20
+ *  Author: valen
+ */ 
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "Pulsos.h"
+
+// Parte alta de la cuenta: desbordes del Timer1
+static volatile uint16_t desbordes = 0;
+
+// Estados de la medicin lista para Pulsos_Medicion
+#define MEDICION_NINGUNA	0
+#define MEDICION_NUEVA		1
+#define MEDICION_SIN_SENAL	2
+
+// Medicin por captura (las variables sin volatile solo las usa la ISR de captura)
+static uint8_t promedio = 1;				// Perodos por medicin
+static volatile uint8_t midiendo = 0;		// La captura est activa
+static volatile uint8_t sinFlancos;			// Desbordes desde la ltima captura
+static volatile uint8_t ventanaAbierta;		// Ya hubo la subida que abre la ventana
+static volatile uint32_t flancos;			// Subidas desde Pulsos_Medir
+static uint32_t inicio;						// Subida que abri la ventana (cuentas de 62.5 ns)
+static uint32_t subida;						// ltima subida
+static uint32_t altoSuma;					// Tiempo en alto dentro de la ventana
+static uint8_t periodos;					// Perodos completos dentro de la ventana
+
+// ltima ventana completa
+static volatile uint8_t listo = MEDICION_NINGUNA;
+static volatile uint32_t listoSuma;			// Duracin de los perodos (cuentas)
+static volatile uint32_t listoAlto;			// Tiempo en alto en esos perodos (cuentas)
+static volatile uint8_t listoPeriodos;
+
+void Pulsos_Iniciar(void)
+{
+	DDRD &= ~(1<<DDD5);					// T1 como entrada
+	desbordes = 0;
+	TCCR1A = 0;							// Modo normal, cuenta hasta 0xFFFF
+	TCNT1 = 0;
+	TIFR1 = (1<<TOV1);					// Limpiar un desborde pendiente
+	TIMSK1 |= (1<<TOIE1);
+	TCCR1B = (1<<CS12) | (1<<CS11) | (1<<CS10);	// Reloj externo en T1, flanco de subida
+}
+
+void Pulsos_Medir(uint8_t n)
+{
+	TCCR1B = 0;
+	DDRB &= ~(1<<DDB0);					// ICP1 como entrada
+	promedio = n ? n : 1;
+	desbordes = 0;
+	flancos = 0;
+	sinFlancos = 0;
+	ventanaAbierta = 0;
+	listo = MEDICION_NINGUNA;
+	midiendo = 1;
+	TCCR1A = 0;							// Modo normal, cuenta hasta 0xFFFF
+	TCNT1 = 0;
+	TIFR1 = (1<<ICF1) | (1<<TOV1);		// Limpiar capturas y desbordes pendientes
+	TIMSK1 |= (1<<ICIE1) | (1<<TOIE1);
+	// Filtro de ruido (4 ciclos de retardo, igual en ambos flancos), primero
+	// la subida, reloj del sistema sin prescaler
+	TCCR1B = (1<<ICNC1) | (1<<ICES1) | (1<<CS10);
+}
+
+void Pulsos_Detener(void)
+{
+	TCCR1B = 0;							// Sin reloj
+	TIMSK1 &= ~((1<<TOIE1) | (1<<ICIE1));
+	midiendo = 0;
+}
+
+uint32_t Pulsos_Leer(void)
+{
+	uint16_t alto;
+	uint16_t bajo;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		bajo = TCNT1;
+		alto = desbordes;
+		// Desborde ocurrido pero aun no atendido: TCNT1 ya volvio a empezar
+		if ((TIFR1 & (1<<TOV1)) && bajo < 0x8000)
+		{
+			alto++;
+		}
+	}
+	return ((uint32_t)alto << 16) | bajo;
+}
+
+uint32_t Pulsos_Flancos(void)
+{
+	uint32_t n;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		n = flancos;
+	}
+	return n;
+}
+
+uint8_t Pulsos_Medicion(PulsosMedicion *m)
+{
+	uint8_t estado;
+	uint32_t suma;
+	uint32_t alto;
+	uint8_t n;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		estado = listo;
+		listo = MEDICION_NINGUNA;
+		suma = listoSuma;
+		alto = listoAlto;
+		n = listoPeriodos;
+	}
+
+	if (estado == MEDICION_NINGUNA)
+	{
+		return 0;
+	}
+	if (estado == MEDICION_SIN_SENAL || suma == 0)
+	{
+		m->periodo = 0;
+		m->frecuencia = 0;
+		m->ciclo = 0;
+		m->periodos = 0;
+		return 1;
+	}
+
+	// La frecuencia y el ciclo se calculan con la suma de todos los perodos
+	// para no perder la resolucin que da el promedio
+	m->periodo = (suma + n / 2) / n;
+	m->frecuencia = ((uint64_t)PULSOS_RELOJ * 1000 * n + suma / 2) / suma;
+	m->ciclo = ((uint64_t)alto * 10000 + suma / 2) / suma;
+	m->periodos = n;
+	return 1;
+}
+
+ISR(TIMER1_OVF_vect)
+{
+	desbordes++;
+
+	// Sin flancos durante PULSOS_ESPERA desbordes: la seal se detuvo
+	if (midiendo && sinFlancos < PULSOS_ESPERA && ++sinFlancos == PULSOS_ESPERA)
+	{
+		ventanaAbierta = 0;
+		listo = MEDICION_SIN_SENAL;
+	}
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+	uint16_t bajo = ICR1;
+	uint16_t alto = desbordes;
+	uint32_t t;
+
+	// Desborde anterior a la captura que todava no se atendi
+	if ((TIFR1 & (1<<TOV1)) && bajo < 0x8000)
+	{
+		alto++;
+	}
+	t = ((uint32_t)alto << 16) | bajo;
+	sinFlancos = 0;
+
+	if (TCCR1B & (1<<ICES1))
+	{
+		// Subida: termina un perodo; la prxima captura es la bajada
+		TCCR1B &= ~(1<<ICES1);
+		TIFR1 = (1<<ICF1); // Cambiar el flanco puede activar ICF1
+		flancos++;
+		if (!ventanaAbierta)
+		{
+			ventanaAbierta = 1;
+			inicio = t;
+			periodos = 0;
+			altoSuma = 0;
+		}
+		else if (++periodos >= promedio)
+		{
+			listoSuma = t - inicio;
+			listoAlto = altoSuma;
+			listoPeriodos = periodos;
+			listo = MEDICION_NUEVA;
+			inicio = t;
+			periodos = 0;
+			altoSuma = 0;
+		}
+		subida = t;
+	}
+	else
+	{
+		// Bajada: el pulso en alto pertenece a la ventana de su subida
+		TCCR1B |= (1<<ICES1);
+		TIFR1 = (1<<ICF1);
+		if (ventanaAbierta)
+		{
+			altoSuma += t - subida;
+		}
+	}
+}
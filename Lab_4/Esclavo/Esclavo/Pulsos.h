@@ -0,0 +1,59 @@
+/*
+ * Pulsos.h
+ *
+ * Created: 22/08/2025 08:31:55
+ *  Author: valen
+ */ 
+
+
+#ifndef PULSOS_H_
+#define PULSOS_H_
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// Conteo de pulsos por hardware: el Timer1 usa como reloj el pin T1 (PD5) y
+// solo se interrumpe al CPU cada 65536 pulsos para extender la cuenta a 32 bits.
+// A 16 MHz el pin se muestrea con el reloj del sistema: la frecuencia maxima
+// de entrada es F_CPU/2.5 (~6 MHz) con ciclo de trabajo cercano al 50 %.
+//
+// Medicion de periodo por captura de entrada: el Timer1 corre a 16 MHz y
+// ICP1 (PB0) copia el tiempo de cada flanco en ICR1, con resolucion de
+// 62.5 ns. La ISR alterna entre subida y bajada y acumula el tiempo en alto;
+// cada "promedio" periodos deja lista una medicion que el programa principal
+// convierte con Pulsos_Medicion. Son dos interrupciones cortas por periodo:
+// hasta ~20 kHz la CPU sigue mayormente libre. Sin flancos durante ~1 s se
+// informa que no hay senal (frecuencia minima ~1 Hz).
+
+#define PULSOS_RELOJ		16000000UL	// Timer1 sin prescaler en la medicion
+#define PULSOS_ESPERA		250			// Desbordes de 4.096 ms sin flancos = sin senal
+
+typedef struct
+{
+	uint32_t periodo;		// Periodo promedio en cuentas de 62.5 ns (0 = sin senal)
+	uint32_t frecuencia;	// Frecuencia promedio en mHz
+	uint16_t ciclo;			// Tiempo en alto en centesimas de % (0-10000)
+	uint8_t periodos;		// Periodos promediados (0 = sin senal)
+} PulsosMedicion;
+
+// Configura PD5 como entrada y arranca el conteo desde 0
+void Pulsos_Iniciar(void);
+
+// Configura PB0 (ICP1) como entrada y empieza a medir; cada medicion promedia
+// "promedio" periodos (0 se toma como 1)
+void Pulsos_Medir(uint8_t promedio);
+
+// Detiene el Timer1 en cualquiera de los dos modos (la cuenta se conserva)
+void Pulsos_Detener(void);
+
+// Cuenta de 32 bits; se puede llamar desde el programa principal o desde una ISR
+uint32_t Pulsos_Leer(void);
+
+// Flancos de subida en ICP1 desde Pulsos_Medir (tambien desde una ISR)
+uint32_t Pulsos_Flancos(void);
+
+// Si hay una medicion nueva (o se perdio la senal) la calcula en "m" y
+// devuelve 1. Usa divisiones de 64 bits: llamarla desde el programa principal
+uint8_t Pulsos_Medicion(PulsosMedicion *m);
+
+#endif /* PULSOS_H_ */
@@ -0,0 +1,83 @@
+/*
+ * Registros.h
+ *
+ * Created: 22/08/2025 08:10:37
+ *  Author: valen
+ */ 
+
+
+#ifndef REGISTROS_H_
+#define REGISTROS_H_
+
+#include <stdint.h>
+
+// Mapa de registros del esclavo contador (0x30)
+//
+// Escritura: [SLA+W][registro][datos...]  -> el puntero queda en "registro" y
+//            los datos se guardan con autoincremento (solo en configuracion).
+//            Un primer byte >= REG_COMANDOS es un comando ('R', 'S', ...).
+// Lectura:   [SLA+R][datos...]            -> se leen hasta REG_LECTURA_MAX bytes
+//            desde el puntero, copiados todos juntos al inicio de la lectura,
+//            por lo que los valores de varios bytes llegan completos.
+// Los valores de varios bytes van en little-endian.
+#define NUM_REGISTROS		0x40
+#define REG_COMANDOS		0x40
+#define REG_LECTURA_MAX		16
+
+// Bloque de datos (solo lectura, congelados por el ultimo latch)
+#define REG_CONTADOR		0x00	// u8  nibble bajo de la cuenta (registro por defecto)
+#define REG_CONTEO			0x01	// u32 cuenta completa (botones: 0-15, pulsos: 32 bits)
+#define REG_TS_MUESTRA		0x05	// u32 tiempo de red (us) del ultimo cambio de la cuenta (pulsos: del latch,
+									//     frecuencia: de la ultima medicion)
+#define REG_TS_LATCH		0x09	// u32 tiempo de red (us) del latch
+
+// Medicion por captura (MODO_FRECUENCIA; 0 sin senal o en otros modos)
+#define REG_PERIODO			0x0D	// u32 periodo promedio en cuentas de 62.5 ns
+#define REG_FRECUENCIA		0x11	// u32 frecuencia promedio en mHz
+#define REG_CICLO			0x15	// u16 ciclo de trabajo en centesimas de % (0-10000)
+#define REG_PERIODOS		0x17	// u8  periodos promediados en la medicion publicada
+
+// Bloque de configuracion (lectura/escritura)
+#define REG_CONFIG_INICIO	0x20
+#define REG_MODO			0x20	// u8  MODO_BOTONES / MODO_PULSOS / MODO_FRECUENCIA
+#define REG_PROMEDIO		0x21	// u8  periodos por medicion en MODO_FRECUENCIA (1-255)
+#define REG_CONFIG_FIN		0x28
+
+// Bloque de diagnostico (traza del TWI, ver Traza.h)
+#define REG_TRAZA_CUENTA	0x30	// u8  eventos guardados (0 si no se compilo con TRAZA_TWI)
+#define REG_TRAZA_SEL		0x31	// u8  escribir n congela la traza y publica el evento n (TRAZA_REANUDAR la reanuda)
+#define REG_TRAZA_DATOS		0x32	// 4 bytes del evento: marca de tiempo (u16), estado, dato
+
+// Uso de la SRAM (ver Pila.h), medido por el programa principal despues de cada latch
+#define REG_RAM_ESTATICA	0x36	// u16 bytes de .data + .bss
+#define REG_PILA_MAXIMA		0x38	// u16 maxima profundidad de la pila desde el reset
+#define REG_PILA_LIBRE		0x3A	// u16 bytes que la pila nunca alcanzo (margen minimo)
+
+// Reloj de red (ver Timer.h), actualizado en cada sincronizacion
+#define REG_DERIVA			0x3C	// i16 correccion de frecuencia en decimas de ppm
+
+// Modos de conteo
+#define MODO_BOTONES		0		// Botones en PD2 (+) y PD3 (-), 4 bits
+#define MODO_PULSOS			1		// Flancos de subida en T1 (PD5) contados por el Timer1
+#define MODO_FRECUENCIA		2		// Periodo, frecuencia y ciclo de trabajo en ICP1 (PB0);
+									// REG_CONTEO cuenta las subidas
+
+extern volatile uint8_t registros[NUM_REGISTROS];
+
+// Escritura de valores de varios bytes en el mapa
+// (desde el programa principal se debe llamar dentro de un ATOMIC_BLOCK)
+static inline void Reg_Escribir16(uint8_t reg, uint16_t valor)
+{
+	registros[reg] = valor;
+	registros[reg + 1] = valor >> 8;
+}
+
+static inline void Reg_Escribir32(uint8_t reg, uint32_t valor)
+{
+	registros[reg] = valor;
+	registros[reg + 1] = valor >> 8;
+	registros[reg + 2] = valor >> 16;
+	registros[reg + 3] = valor >> 24;
+}
+
+#endif /* REGISTROS_H_ */
@@ -0,0 +1,54 @@
+/*
+ * Timer.h
+ *
+ * Created: 18/08/2025 09:02:15
+ *  Author: valen
+ */ 
+
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// Inicializa el Timer2 en modo CTC con interrupcion cada 1 ms
+void Timer_init(void);
+
+// Milisegundos transcurridos desde Timer_init
+uint32_t millis(void);
+
+// Microsegundos transcurridos desde Timer_init (resolucion de 4 us)
+uint32_t micros(void);
+
+// Tiempo de red en us: micros() mas la correccion recibida del maestro.
+// En el Maestro la correccion es 0 (su reloj es la referencia de todos)
+uint32_t Timer_Red(void);
+
+// Corrige el reloj de red para que en el instante "local" (un valor de
+// micros()) valga "red". Devuelve el error que tenia antes de corregirlo.
+// Ademas del salto, el error entre dos sincronizaciones seguidas ajusta la
+// frecuencia del reloj de red (deriva del cristal respecto del maestro)
+int32_t Timer_Sincronizar(uint32_t local, uint32_t red);
+
+// Correccion de frecuencia aplicada, en decimas de ppm
+// (positiva = el cristal local atrasa respecto del maestro)
+int16_t Timer_Deriva(void);
+
+// Limites de la correccion de frecuencia
+#define TIMER_SINC_MIN_US	100000UL	// Intervalo entre sincronizaciones que se usa para medir
+#define TIMER_SINC_MAX_US	10000000UL
+#define TIMER_ERROR_MAX_US	2000		// Error mayor: solo salto (reset o sincronizacion perdida)
+#define TIMER_TASA_MAX		32768		// 500 ppm (tolerancia de cualquier cristal)
+
+// Contador de milisegundos (lo incrementa la ISR del Timer2)
+extern volatile uint32_t timerMilisegundos;
+
+// Marca de tiempo corta y barata (2 lecturas, sin bloquear interrupciones)
+// para trazas: byte alto = ms modulo 256, byte bajo = cuentas de 4 us (0-249)
+static inline uint16_t Timer_Marca(void)
+{
+	return ((uint16_t)(*(volatile uint8_t *)&timerMilisegundos) << 8) | TCNT2;
+}
+
+#endif /* TIMER_H_ */
@@ -9,19 +9,117 @@
 
 #include <avr/io.h>        // Librera base de registros para AVR
 #include <avr/interrupt.h> // Librera para manejo de interrupciones
+#include <util/atomic.h>   // Librera para accesos atmicos a variables compartidas con ISR
 #include <util/delay.h>    // Librera para retardos
 #include "I2C.h"           // Librera personalizada para comunicacin I2C
+#include "Pila.h"          // Uso mximo de la pila y margen de SRAM
+#include "Pulsos.h"        // Conteo de pulsos externos con el Timer1
+#include "Registros.h"     // Mapa de registros accesible por I2C
+#include "Timer.h"         // Base de tiempo (Timer2) para las marcas de la traza
+#include "Traza.h"         // Traza opcional de los estados del TWI (TRAZA_TWI)
 
 // Direccin del esclavo
 #define SlaveAddress 0x30
 
+// Modo de conteo al encender (se puede cambiar con -D al compilar o por I2C)
+#ifndef MODO_DEFECTO
+#define MODO_DEFECTO MODO_BOTONES
+#endif
+
+// Perodos por medicin en modo frecuencia al encender
+#define PROMEDIO_DEFECTO 8
+
+// Tiempo que los botones deben quedar estables para aceptar el cambio
+#define REBOTE_MS 20
+
 // Variables globales
 uint8_t buffer = 0;             // Almacena datos recibidos por I2C
 uint8_t contador4bits = 0;      // Contador limitado a 4 bits (0-15)
+volatile uint8_t modo = MODO_BOTONES; // Modo de conteo activo
+volatile uint32_t tiempoConteo = 0;   // Tiempo de red (us) del ltimo cambio por botones o de la ltima medicin
+PulsosMedicion medicion;              // ltima medicin del modo frecuencia (la publica el latch)
+volatile uint32_t tiempoFlanco = 0;   // Tiempo de red del primer flanco de los botones sin atender
+volatile uint8_t flancoPendiente = 0;
+
+// Registros accesibles por I2C y estado de la transaccin en curso
+volatile uint8_t registros[NUM_REGISTROS];
+uint8_t puntero = REG_CONTADOR;         // Registro de la prxima lectura o escritura
+uint8_t primerDato = 0;                 // 1 = el prximo byte recibido es registro o comando
+uint8_t txBuffer[REG_LECTURA_MAX];      // Copia de los registros que se estn enviando
+uint8_t txIndice = 0;
+volatile uint8_t configPendiente = 0;   // El maestro escribi en el bloque de configuracin
+volatile uint8_t memoriaPendiente = 1;  // Hubo un latch: volver a medir la pila
+
+// Sincronizacin del reloj de red (llamada general 'T' + 4 bytes de tiempo)
+uint32_t sincLocal;                     // micros() al recibir el comando
+uint32_t sincTiempo;                    // Tiempo del maestro que se va armando
+uint8_t sincIndice = 4;                 // Bytes de tiempo recibidos (4 = sin sincronizacin en curso)
 
 // Prototipos de funciones
 void initPorts(void);
 void setup(void);
+void aplicarModo(uint8_t nuevo);
+void atenderBotones(void);
+
+// Congela la cuenta actual en el bloque de datos (se llama desde la ISR)
+static inline void latchDatos(void)
+{
+	uint32_t conteo;
+	uint32_t ahora = Timer_Red();
+
+	if (modo == MODO_PULSOS)
+	{
+		conteo = Pulsos_Leer();
+	}
+	else if (modo == MODO_FRECUENCIA)
+	{
+		conteo = Pulsos_Flancos();
+	}
+	else
+	{
+		conteo = contador4bits;
+	}
+
+	registros[REG_CONTADOR] = conteo & 0x0F;
+	Reg_Escribir32(REG_CONTEO, conteo);
+	// En modo pulsos la cuenta se toma en este instante
+	Reg_Escribir32(REG_TS_MUESTRA, (modo == MODO_PULSOS) ? ahora : tiempoConteo);
+	Reg_Escribir32(REG_TS_LATCH, ahora);
+	Reg_Escribir32(REG_PERIODO, medicion.periodo);
+	Reg_Escribir32(REG_FRECUENCIA, medicion.frecuencia);
+	Reg_Escribir16(REG_CICLO, medicion.ciclo);
+	registros[REG_PERIODOS] = medicion.periodos;
+	puntero = REG_CONTADOR; // La siguiente lectura simple devuelve el nibble bajo
+	memoriaPendiente = 1;
+}
+
+// Publica el uso de la pila (desde el programa principal: Pila_Libre no es reentrante)
+static inline void publicarMemoria(void)
+{
+	uint16_t libre = Pila_Libre();
+	uint16_t maxima = Pila_Maxima();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Reg_Escribir16(REG_PILA_MAXIMA, maxima);
+		Reg_Escribir16(REG_PILA_LIBRE, libre);
+	}
+}
+
+// Publica el evento n de la traza en REG_TRAZA_DATOS (se llama desde la ISR)
+static inline void seleccionarTraza(uint8_t n)
+{
+	uint8_t evento[4] = {0, 0, 0, 0};
+
+	Traza_Congelar(n != TRAZA_REANUDAR); // Congelada mientras el maestro la lee
+	Traza_Leer(n, evento);
+	registros[REG_TRAZA_CUENTA] = Traza_Cuenta();
+	registros[REG_TRAZA_SEL] = n;
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		registros[REG_TRAZA_DATOS + i] = evento[i];
+	}
+}
 
 //******************************************************************
 
@@ -30,11 +128,58 @@ int main(void)
 	initPorts(); // Configura pines de entrada/salida
 	setup();     // Configura interrupciones externas y pull-ups
 	
+	registros[REG_PROMEDIO] = PROMEDIO_DEFECTO;
+	aplicarModo(MODO_DEFECTO);
+	Reg_Escribir16(REG_RAM_ESTATICA, Pila_Estatica());
+	Timer_init(); // Reloj de red y marcas de tiempo de la traza del TWI
+	
 	I2C_Slave_Init(SlaveAddress); // Inicializa el esclavo I2C con la direccin 0x30
 	sei(); // Habilita interrupciones globales
 
 	while (1)
 	{
+		// El maestro cambi el modo de conteo o el promedio por I2C
+		if (configPendiente)
+		{
+			configPendiente = 0;
+			aplicarModo(registros[REG_MODO]);
+		}
+
+		// En modo frecuencia las divisiones de la medicin se hacen aqu, no en la ISR
+		PulsosMedicion nueva;
+		if (modo == MODO_FRECUENCIA && Pulsos_Medicion(&nueva))
+		{
+			uint32_t ahora = Timer_Red();
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				medicion = nueva;
+				tiempoConteo = ahora;
+			}
+		}
+
+		// En modo pulsos y frecuencia los LEDs de PC0-PC3 muestran el nibble bajo de la cuenta
+		if (modo == MODO_PULSOS)
+		{
+			contador4bits = Pulsos_Leer() & 0x0F;
+			PORTC = (PORTC & 0xF0) | contador4bits;
+		}
+		else if (modo == MODO_FRECUENCIA)
+		{
+			contador4bits = Pulsos_Flancos() & 0x0F;
+			PORTC = (PORTC & 0xF0) | contador4bits;
+		}
+		else
+		{
+			atenderBotones();
+		}
+
+		// Uso de la pila hasta el ltimo latch, para la prxima lectura del maestro
+		if (memoriaPendiente)
+		{
+			memoriaPendiente = 0;
+			publicarMemoria();
+		}
+
 		// Si el maestro escribe 'R', se limpia el buffer (respuesta automtica se da en ISR)
 		if (buffer == 'R')
 		{
@@ -44,36 +189,103 @@ int main(void)
 }
 
 // Interrupcin del perifrico TWI (I2C)
-ISR(TWI0_vect)
+ISR(TWI_VECTOR)
 {
 	uint8_t estado;
-	estado = TWSR0 & 0xFC; // Se lee el estado de TWI (enmascarando bits menos significativos)
+	estado = TWI_Estado(); // Se lee el estado de TWI (enmascarando bits menos significativos)
+	TRAZA(estado, TWI_TWDR);  // Solo si se compil con TRAZA_TWI (pocos ciclos)
 
 	switch (estado)
 	{
 		// El esclavo ha sido seleccionado con una escritura (SLA+W)
-		case 0x60: // Direccin + write (propia)
-		case 0x70: // Direccin general + write
-			TWCR0 |= (1 << TWINT); // Limpia la bandera para continuar
+		case TWI_SR_SLA_ACK: // Direccin + write (propia)
+		case TWI_SR_GENERAL_ACK: // Direccin general + write
+			primerDato = 1;        // El primer byte ser un registro o un comando
+			TWI_TWCR |= (1 << TWINT); // Limpia la bandera para continuar
 			break;
 
 		// El maestro ha enviado un dato al esclavo
-		case 0x80: // Datos recibidos con direccin propia
-		case 0x90: // Datos recibidos con direccin general
-			buffer = TWDR0;        // Se guarda el dato recibido
-			TWCR0 |= (1 << TWINT); // Limpia la bandera para continuar
+		case TWI_SR_DATO_ACK: // Datos recibidos con direccin propia
+			buffer = TWI_TWDR;        // Se guarda el dato recibido
+			if (primerDato)
+			{
+				primerDato = 0;
+				if (buffer >= REG_COMANDOS)
+				{
+					if (buffer == 'R')
+					{
+						latchDatos(); // Congela el contador para la prxima lectura
+					}
+				}
+				else
+				{
+					puntero = buffer; // Seleccin de registro
+				}
+			}
+			else if (puntero >= REG_CONFIG_INICIO && puntero < REG_CONFIG_FIN)
+			{
+				registros[puntero++] = buffer; // Escritura con autoincremento
+				configPendiente = 1;
+			}
+			else if (puntero == REG_TRAZA_SEL)
+			{
+				seleccionarTraza(buffer);
+			}
+			TWI_TWCR |= (1 << TWINT); // Limpia la bandera para continuar
+			break;
+
+		case TWI_SR_GENERAL_DATO_ACK: // Datos recibidos con direccin general
+			buffer = TWI_TWDR;
+			if (primerDato)
+			{
+				primerDato = 0;
+				sincIndice = 4;
+				if (buffer == I2C_CMD_LATCH)
+				{
+					latchDatos(); // Todos los esclavos congelan su dato en el mismo instante
+				}
+				else if (buffer == I2C_CMD_TIEMPO)
+				{
+					// El maestro toma su tiempo al recibir este mismo ACK
+					sincLocal = micros();
+					sincTiempo = 0;
+					sincIndice = 0;
+				}
+			}
+			else if (sincIndice < 4)
+			{
+				sincTiempo |= (uint32_t)buffer << (8 * sincIndice);
+				if (++sincIndice == 4)
+				{
+					Timer_Sincronizar(sincLocal, sincTiempo);
+					Reg_Escribir16(REG_DERIVA, Timer_Deriva());
+				}
+			}
+			TWI_TWCR |= (1 << TWINT);
 			break;
 
 		// El maestro solicita datos al esclavo (SLA+R)
-		case 0xA8: // Direccin + read (propia)
-		case 0xB8: // Se envi el dato y el maestro espera ms
-			TWDR0 = contador4bits; // Se enva el valor del contador como respuesta
-			TWCR0 = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA); // Configura para enviar y seguir escuchando
+		case TWI_ST_SLA_ACK: // Direccin + read (propia)
+			// Se copian juntos los registros a enviar para que la cuenta de 32 bits
+			// no cambie a mitad de la lectura
+			for (uint8_t i = 0; i < REG_LECTURA_MAX; i++)
+			{
+				txBuffer[i] = registros[(puntero + i) & (NUM_REGISTROS - 1)];
+			}
+			txIndice = 0;
+			// no break: se enva el primer byte
+		case TWI_ST_DATO_ACK: // Se envi el dato y el maestro espera ms
+			TWI_TWDR = txBuffer[txIndice]; // Se enva el siguiente registro como respuesta
+			if (txIndice < REG_LECTURA_MAX - 1)
+			{
+				txIndice++;
+			}
+			TWI_TWCR = (1 << TWEN) | (1 << TWIE) | (1 << TWINT) | (1 << TWEA); // Configura para enviar y seguir escuchando
 			break;
 
 		// Cualquier otro estado inesperado
 		default:
-			TWCR0 |= (1 << TWINT) | (1 << TWSTO); // Limpia bandera y libera bus para evitar bloqueos
+			TWI_TWCR |= (1 << TWINT) | (1 << TWSTO); // Limpia bandera y libera bus para evitar bloqueos
 			break;
 	}
 }
@@ -108,34 +320,123 @@ void setup(void)
 	sei(); // Habilita interrupciones globales
 }
 
-// Interrupcin por cambio en PD2 o PD3 (botones)
-ISR(PCINT2_vect)
+// Cambia el modo de conteo: en modo pulsos el Timer1 cuenta desde T1 (PD5)
+// y en modo frecuencia captura los flancos de ICP1 (PB0)
+void aplicarModo(uint8_t nuevo)
 {
-	// Si se presiona PD2 (botn de incremento)
-	if (!(PIND & (1 << PIND2)))
+	if (nuevo != MODO_PULSOS && nuevo != MODO_FRECUENCIA)
 	{
-		contador4bits++; // Incrementa el contador
-		contador4bits &= 0x0F; // Asegura que no pase de 4 bits (0-15)
-		_delay_ms(250); // Antirrebote simple
+		nuevo = MODO_BOTONES;
+	}
 
-		// Actualiza los pines de salida PC0-PC3
-		PORTC = (PORTC & 0xF0) | (contador4bits & 0x0F);
+	// Los dos modos usan el Timer1: primero se libera el del modo anterior
+	if (modo == MODO_PULSOS && nuevo != MODO_PULSOS)
+	{
+		Pulsos_Detener();
+		DDRD |= (1 << DDD5); // PD5 vuelve a ser salida
+	}
+	else if (modo == MODO_FRECUENCIA)
+	{
+		Pulsos_Detener();
 	}
-	// Si se presiona PD3 (botn de decremento)
-	else if (!(PIND & (1 << PIND3)))
+	if (nuevo != modo)
+	{
+		contador4bits = 0;
+		PORTC = PORTC & 0xF0;
+	}
+
+	// Fuera del modo frecuencia la medicin se publica en 0; en ese modo
+	// tambin se reinicia (puede haber cambiado el promedio) y vale 0 hasta
+	// la primera medicin (sin seal)
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 	{
-		// Manejo de underflow: si est en 0, pasa a 15
-		if (contador4bits == 0)
+		medicion.periodo = 0;
+		medicion.frecuencia = 0;
+		medicion.ciclo = 0;
+		medicion.periodos = 0;
+	}
+
+	if (nuevo == MODO_PULSOS)
+	{
+		if (modo != MODO_PULSOS)
 		{
-			contador4bits = 15;
+			Pulsos_Iniciar(); // PD5 pasa a ser entrada y la cuenta arranca en 0
 		}
-		else
+	}
+	else if (nuevo == MODO_FRECUENCIA)
+	{
+		Pulsos_Medir(registros[REG_PROMEDIO]);
+	}
+	modo = nuevo;
+	registros[REG_MODO] = nuevo;
+}
+
+// Antirrebote de PD2 (+) y PD3 (-) fuera de la ISR: una pulsacin cuenta
+// cuando los pines quedan estables REBOTE_MS, con el tiempo de red del
+// primer flanco que marc la ISR
+void atenderBotones(void)
+{
+	static uint8_t estable = (1 << PIND2) | (1 << PIND3); // Sueltos (pull-up)
+	static uint8_t lectura = (1 << PIND2) | (1 << PIND3);
+	static uint32_t desde = 0;
+	uint8_t pines = PIND & ((1 << PIND2) | (1 << PIND3));
+	uint8_t presionados;
+	uint32_t ahora = millis();
+
+	// Cada cambio reinicia la espera
+	if (pines != lectura)
+	{
+		lectura = pines;
+		desde = ahora;
+		return;
+	}
+	if (ahora - desde < REBOTE_MS)
+	{
+		return;
+	}
+	if (pines == estable)
+	{
+		// Un rebote o una interferencia que volvi al estado estable: el flanco
+		// marcado no era una pulsacin y no debe tapar el de la prxima
+		flancoPendiente = 0;
+		return;
+	}
+
+	presionados = estable & ~pines; // Pasaron de suelto (1) a presionado (0)
+	estable = pines;
+	if (presionados & (1 << PIND2))
+	{
+		contador4bits = (contador4bits + 1) & 0x0F; // Incrementa (15 pasa a 0)
+	}
+	else if (presionados & (1 << PIND3))
+	{
+		contador4bits = (contador4bits - 1) & 0x0F; // Decrementa (0 pasa a 15)
+	}
+	if (presionados)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 		{
-			contador4bits--;
+			tiempoConteo = tiempoFlanco;
 		}
-		_delay_ms(250); // Antirrebote
-
 		// Actualiza los pines de salida PC0-PC3
-		PORTC = (PORTC & 0xF0) | (contador4bits & 0x0F);
+		PORTC = (PORTC & 0xF0) | contador4bits;
+	}
+	flancoPendiente = 0; // El prximo flanco es de otra pulsacin o de la soltada
+}
+
+// Interrupcin por cambio en PD2 o PD3 (botones): solo marca el instante del
+// primer flanco. Sin retardos aqu, para no atrasar el Timer2 del reloj de red
+ISR(PCINT2_vect)
+{
+	// Los botones solo modifican la cuenta en modo botones
+	if (modo != MODO_BOTONES)
+	{
+		return;
+	}
+
+	if (!flancoPendiente)
+	{
+		tiempoFlanco = Timer_Red();
+		flancoPendiente = 1;
 	}
 }
@@ -0,0 +1,87 @@
+/*
+ * TWI.h
+ *
+ * Created: 19/10/2025 05:55:02
+ *  Author: valen
+ */ 
+
+
+#ifndef HAL_TWI_H_
+#define HAL_TWI_H_
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// Capa comun del TWI para los tres nodos. Solo tiene macros y constantes que
+// el compilador resuelve, por lo que el codigo generado es el mismo que con
+// los registros y los numeros escritos a mano.
+//
+// El Maestro y el Esclavo usan el TWI0 del ATmega328PB y el Esclavo 2 el TWI
+// del ATmega328P: con estos nombres el mismo fuente sirve en los dos.
+#ifdef TWCR0
+#define TWI_TWBR	TWBR0
+#define TWI_TWSR	TWSR0
+#define TWI_TWCR	TWCR0
+#define TWI_TWDR	TWDR0
+#define TWI_TWAR	TWAR0
+#define TWI_VECTOR	TWI0_vect
+#else
+#define TWI_TWBR	TWBR
+#define TWI_TWSR	TWSR
+#define TWI_TWCR	TWCR
+#define TWI_TWDR	TWDR
+#define TWI_TWAR	TWAR
+#define TWI_VECTOR	TWI_vect
+#endif
+
+// Codigos de estado del TWSR con los bits del prescaler en 0 (hoja de datos,
+// tablas de los modos maestro transmisor/receptor y esclavo receptor/transmisor).
+// Se comparan con un uint8_t (TWI_Estado), no se guardan como enum: en el AVR
+// un enum ocupa 2 bytes
+typedef enum
+{
+	// Maestro
+	TWI_START				= 0x08,	// START enviado
+	TWI_START_REPETIDO		= 0x10,	// START repetido enviado
+	TWI_MT_SLA_ACK			= 0x18,	// SLA+W enviado, ACK recibido
+	TWI_MT_SLA_NACK			= 0x20,
+	TWI_MT_DATO_ACK			= 0x28,	// Dato enviado, ACK recibido
+	TWI_MT_DATO_NACK		= 0x30,
+	TWI_ARBITRAJE_PERDIDO	= 0x38,
+	TWI_MR_SLA_ACK			= 0x40,	// SLA+R enviado, ACK recibido
+	TWI_MR_SLA_NACK			= 0x48,
+	TWI_MR_DATO_ACK			= 0x50,	// Dato recibido, ACK devuelto
+	TWI_MR_DATO_NACK		= 0x58,	// Dato recibido, NACK devuelto (ultimo)
+
+	// Esclavo receptor
+	TWI_SR_SLA_ACK			= 0x60,	// Direccion propia + escritura
+	TWI_SR_GENERAL_ACK		= 0x70,	// Llamada general
+	TWI_SR_DATO_ACK			= 0x80,	// Dato recibido con la direccion propia
+	TWI_SR_GENERAL_DATO_ACK	= 0x90,	// Dato recibido con la llamada general
+	TWI_SR_STOP				= 0xA0,	// STOP o START repetido
+
+	// Esclavo transmisor
+	TWI_ST_SLA_ACK			= 0xA8,	// Direccion propia + lectura
+	TWI_ST_DATO_ACK			= 0xB8,	// Dato enviado, el maestro pide otro
+	TWI_ST_DATO_NACK		= 0xC0,	// Dato enviado, NACK (fin de la lectura)
+	TWI_ST_ULTIMO_ACK		= 0xC8,	// Ultimo dato (TWEA = 0) enviado, ACK recibido
+
+	TWI_SIN_ESTADO			= 0xF8,	// Sin informacion (TWINT = 0)
+	TWI_ERROR_BUS			= 0x00	// START o STOP fuera de lugar
+} EstadoTWI;
+
+#define TWI_MASCARA_ESTADO	0xF8	// Descarta TWPS1:0 y el bit reservado
+
+// Estado actual del TWI
+static inline uint8_t TWI_Estado(void)
+{
+	return TWI_TWSR & TWI_MASCARA_ESTADO;
+}
+
+// Espera a que el TWI termine la operacion en curso (TWINT en 1)
+static inline void TWI_Esperar(void)
+{
+	while (!(TWI_TWCR & (1 << TWINT)));
+}
+
+#endif /* HAL_TWI_H_ */
@@ -0,0 +1,52 @@
+#!/bin/sh
+# comparar.sh - Compara el codigo que genera avr-gcc para los fuentes que usan
+# la capa del TWI (HAL/TWI.h) con el de una revision anterior escrita a mano.
+#
+# Uso (desde Lab_4):  HAL/comparar.sh [revision]    (por defecto HEAD~1)
+#
+# Para cada nodo compila I2C.c y main.c con las opciones de Release (-Os) en
+# las dos versiones e imprime el tamano de .text y si el desensamblado es
+# identico. Mismo codigo = mismo tamano y mismos ciclos.
+
+REV=${1:-HEAD~1}
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+git archive "$REV" . | tar -x -C "$TMP" || exit 1
+
+CFLAGS="-Os -std=gnu99 -funsigned-char -funsigned-bitfields -ffunction-sections -fdata-sections -fpack-struct -fshort-enums -DF_CPU=16000000UL -DNDEBUG"
+
+compilar() # directorio mcu fuente salida
+{
+	avr-gcc $CFLAGS -mmcu="$2" -c "$1/$3" -o "$4" 2>/dev/null
+}
+
+tam() # objeto
+{
+	avr-size -A "$1" | awk '$1 ~ /^\.text/ { t += $2 } END { print t + 0 }'
+}
+
+estado=0
+for nodo in "Maestro/Maestro:atmega328pb" "Esclavo/Esclavo:atmega328pb" "Esclavo 2/Esclavo 2:atmega328p"
+do
+	dir=${nodo%%:*}
+	mcu=${nodo##*:}
+	for f in I2C.c main.c
+	do
+		if ! compilar "$TMP/$dir" "$mcu" "$f" "$TMP/antes.o" || ! compilar "$dir" "$mcu" "$f" "$TMP/ahora.o"
+		then
+			echo "$dir/$f: no compila"
+			estado=1
+			continue
+		fi
+		avr-objdump -d "$TMP/antes.o" | tail -n +4 > "$TMP/antes.s"
+		avr-objdump -d "$TMP/ahora.o" | tail -n +4 > "$TMP/ahora.s"
+		if cmp -s "$TMP/antes.s" "$TMP/ahora.s"
+		then
+			igual="identico"
+		else
+			igual="distinto"
+		fi
+		echo "$dir/$f: .text $(tam "$TMP/antes.o") -> $(tam "$TMP/ahora.o") bytes, $igual"
+	done
+done
+exit $estado
@@ -0,0 +1,241 @@
+/*
+ * telemetria_csv.c
+ *
+ * Decodificador (lado PC) de la telemetria binaria del Maestro.
+ * Lee una captura del puerto serie y escribe una linea CSV por trama.
+ *
+ * Compilar:  cc -O2 -o telemetria_csv telemetria_csv.c
+ * Capturar:  stty -F /dev/ttyUSB0 1000000 raw && cat /dev/ttyUSB0 > captura.bin
+ * Usar:      ./telemetria_csv captura.bin > muestras.csv
+ *            (sin argumento lee de la entrada estandar)
+ *
+ * El formato de las tramas esta descrito en Maestro/Maestro/Telemetria.h
+ * La primera columna es el tipo de trama; las siguientes dependen del tipo:
+ *   muestra,tiempo_us,direccion,registro,valor
+ *   arranque,tiempo_ms,causa_reset,esclavos
+ *   traza,nodo,indice,ms_mod256,us,estado,dato
+ *     (nodo 0x00 = maestro; us = microsegundos dentro de ese milisegundo)
+ *   tiempo,direccion,latencia_us,desfase_us
+ *   bitacora,indice,dispositivo,tiempo_ms,valor
+ *     (registros de la EEPROM del Maestro, del mas viejo al mas nuevo;
+ *      dispositivo 0 = contador, 1 = ADC, 3 = reloj. Un tiempo menor que el
+ *      de la linea anterior indica un reset)
+ *   evento,direccion,tipo,valor,tiempo_us
+ *     (tipo: 1/2 entra/sale de la zona baja, 3/4 de la alta, 5/6 sube/baja rapido)
+ *   memoria,nodo,estatica,pila_maxima,libre
+ *     (bytes de SRAM; nodo 0x00 = maestro)
+ *   estadistica,direccion,muestras,minimo,maximo,media,varianza,desvio
+ *     (ultimas lecturas de cada esclavo en el Maestro)
+ *   deriva,direccion,ppm
+ *     (correccion de frecuencia del reloj de red del esclavo)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define TELE_SYNC		0xA5
+#define TELE_MAX_DATOS	24
+
+#define TELE_MUESTRA	0x01
+#define TELE_ARRANQUE	0x02
+#define TELE_TRAZA		0x03
+#define TELE_TIEMPO		0x04
+#define TELE_BITACORA	0x05
+#define TELE_EVENTO		0x06
+#define TELE_MEMORIA	0x07
+#define TELE_ESTADISTICA 0x08
+#define TELE_DERIVA		0x09
+
+// Formato de los registros: ver Maestro/Maestro/Bitacora.h
+#define BITACORA_RELOJ	3
+#define VALOR_MASCARA	0x3FFFFFUL
+
+// Estado de la decodificacion de la bitacora (las claves fijan los valores
+// y el tiempo absolutos, los deltas los modifican)
+static uint32_t bitTiempo, bitValor[BITACORA_RELOJ];
+static int bitTiempoConocido = 0, bitValorConocido[BITACORA_RELOJ];
+
+static void decodificar_bitacora(uint8_t indice, const uint8_t *r)
+{
+	uint8_t disp = r[1] >> 6;
+	uint32_t v = ((uint32_t)(r[1] & 0x3F) << 16) | ((uint32_t)r[2] << 8) | r[3];
+
+	if (r[0] == 0xFF) return;	// Registro vacio
+
+	if (r[0] & 0x80)
+	{
+		// Clave: valor absoluto de 22 bits
+		if (disp == BITACORA_RELOJ)
+		{
+			bitTiempo = v;
+			bitTiempoConocido = 1;
+			printf("bitacora,%u,%u,%lu,\n", indice, disp, (unsigned long)bitTiempo * 10);
+			return;
+		}
+		bitValor[disp] = v;
+		bitValorConocido[disp] = 1;
+	}
+	else
+	{
+		// Delta: dt de 14 bits (10 ms) y cambio de 8 bits con signo
+		if (!bitTiempoConocido || disp == BITACORA_RELOJ) return;
+		bitTiempo += ((uint32_t)(r[1] & 0x3F) << 8) | r[2];
+		bitValor[disp] = (bitValor[disp] + (uint32_t)(int32_t)(int8_t)r[3]) & VALOR_MASCARA;
+	}
+
+	if (bitTiempoConocido && bitValorConocido[disp])
+	{
+		printf("bitacora,%u,%u,%lu,%lu\n", indice, disp, (unsigned long)bitTiempo * 10, (unsigned long)bitValor[disp]);
+	}
+}
+
+static uint16_t leer_u16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t leer_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Imprime una trama valida; devuelve 0 si el tipo o el largo no se conocen
+static int imprimir_trama(uint8_t tipo, const uint8_t *d, uint8_t largo)
+{
+	switch (tipo)
+	{
+		case TELE_MUESTRA:
+			if (largo != 10) return 0;
+			printf("muestra,%lu,0x%02X,0x%02X,%lu\n", (unsigned long)leer_u32(&d[0]),
+				d[4], d[5], (unsigned long)leer_u32(&d[6]));
+			return 1;
+
+		case TELE_ARRANQUE:
+			if (largo != 4) return 0;
+			printf("arranque,%u,0x%02X,0x%02X\n", leer_u16(&d[0]), d[2], d[3]);
+			return 1;
+
+		case TELE_TRAZA:
+			if (largo != 6) return 0;
+			// Marca: byte alto = ms mod 256, byte bajo = cuentas de 4 us del Timer2
+			printf("traza,0x%02X,%u,%u,%u,0x%02X,0x%02X\n", d[0], d[1], d[3], d[2] * 4u, d[4], d[5]);
+			return 1;
+
+		case TELE_TIEMPO:
+			if (largo != 9) return 0;
+			printf("tiempo,0x%02X,%lu,%ld\n", d[0], (unsigned long)leer_u32(&d[1]), (long)(int32_t)leer_u32(&d[5]));
+			return 1;
+
+		case TELE_BITACORA:
+			if (largo != 5) return 0;
+			decodificar_bitacora(d[0], &d[1]);
+			return 1;
+
+		case TELE_EVENTO:
+			if (largo != 8) return 0;
+			printf("evento,0x%02X,%u,%u,%lu\n", d[0], d[1], leer_u16(&d[2]), (unsigned long)leer_u32(&d[4]));
+			return 1;
+
+		case TELE_MEMORIA:
+			if (largo != 7) return 0;
+			printf("memoria,0x%02X,%u,%u,%u\n", d[0], leer_u16(&d[1]), leer_u16(&d[3]), leer_u16(&d[5]));
+			return 1;
+
+		case TELE_ESTADISTICA:
+			if (largo != 18) return 0;
+			// Media y desvio llegan en decimas
+			printf("estadistica,0x%02X,%u,%u,%u,%lu.%lu,%lu,%lu.%lu\n", d[0], d[1], leer_u16(&d[2]), leer_u16(&d[4]),
+				(unsigned long)leer_u32(&d[6]) / 10, (unsigned long)leer_u32(&d[6]) % 10, (unsigned long)leer_u32(&d[10]),
+				(unsigned long)leer_u32(&d[14]) / 10, (unsigned long)leer_u32(&d[14]) % 10);
+			return 1;
+
+		case TELE_DERIVA:
+			if (largo != 3) return 0;
+			printf("deriva,0x%02X,%.1f\n", d[0], (int16_t)leer_u16(&d[1]) / 10.0);
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+// Bytes devueltos a la entrada (en orden inverso) para volver a buscar el
+// 0xA5 dentro de una trama descartada: cabecera, datos y chk como maximo
+static uint8_t devueltos[TELE_MAX_DATOS + 3];
+static int numDevueltos = 0;
+
+static int leer_byte(FILE *f)
+{
+	if (numDevueltos > 0) return devueltos[--numDevueltos];
+	return fgetc(f);
+}
+
+// Devuelve los n bytes leidos despues de un 0xA5 que no era inicio de trama
+static void devolver(const uint8_t *bytes, int n)
+{
+	while (n > 0) devueltos[numDevueltos++] = bytes[--n];
+}
+
+int main(int argc, char **argv)
+{
+	FILE *entrada = stdin;
+	uint8_t leidos[TELE_MAX_DATOS + 3];	// tipo, largo, datos y chk
+	uint8_t *trama = &leidos[2];
+	unsigned long validas = 0, errores = 0, desconocidas = 0;
+	int c;
+
+	if (argc > 1 && (entrada = fopen(argv[1], "rb")) == NULL)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	printf("tipo,tiempo_us,direccion,registro,valor\n");
+
+	while ((c = leer_byte(entrada)) != EOF)
+	{
+		int tipo, largo, chk, i;
+
+		if (c != TELE_SYNC) continue;	// Resincronizar con el siguiente 0xA5
+
+		if ((tipo = leer_byte(entrada)) == EOF || (largo = leer_byte(entrada)) == EOF) break;
+		leidos[0] = (uint8_t)tipo;
+		leidos[1] = (uint8_t)largo;
+		if (largo > TELE_MAX_DATOS)
+		{
+			errores++;
+			devolver(leidos, 2);		// La busqueda sigue desde el byte despues del 0xA5
+			continue;
+		}
+
+		chk = tipo ^ largo;
+		for (i = 0; i <= largo; i++)	// Datos + byte de chk
+		{
+			if ((c = leer_byte(entrada)) == EOF) break;
+			trama[i] = (uint8_t)c;
+			if (i < largo) chk ^= c;
+		}
+		if (i <= largo) break;			// Captura cortada a mitad de trama
+
+		if (chk != trama[largo])
+		{
+			// Un 0xA5 dentro de la trama mala puede ser el inicio de una buena
+			errores++;
+			devolver(leidos, largo + 3);
+			continue;
+		}
+
+		if (imprimir_trama((uint8_t)tipo, trama, (uint8_t)largo))
+		{
+			validas++;
+		}
+		else
+		{
+			desconocidas++;
+		}
+	}
+
+	fprintf(stderr, "tramas validas: %lu, con error: %lu, desconocidas: %lu\n", validas, errores, desconocidas);
+	if (entrada != stdin) fclose(entrada);
+	return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * Bitacora.c
+ *
+ * Created: 29/08/2025 08:14:31
+ *  Author: valen
+ */ 
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "Bitacora.h"
+
+#define BITACORA_MASCARA	(BITACORA_COLA - 1)
+#define SECUENCIAS			127			// La secuencia 0x7F queda para los registros vacos
+#define CLAVE				0x80
+#define DT_MAX				0x3FFF		// 14 bits de 10 ms (~163 s)
+#define VALOR_MASCARA		0x3FFFFFUL	// 22 bits
+
+typedef struct
+{
+	uint8_t posicion;	// Registro del anillo (direccin = posicion * 4)
+	uint8_t datos[4];
+} Pendiente;
+
+// Cola hacia la ISR: el programa principal escribe en colaCabeza, la ISR lee en colaCola
+static volatile Pendiente cola[BITACORA_COLA];
+static volatile uint8_t colaCabeza = 0;
+static volatile uint8_t colaCola = 0;
+static uint8_t byteActual = 0;			// Paso de la escritura del registro (ver EE_READY_vect)
+
+// Estado del codificador (solo programa principal)
+static uint8_t siguiente = 0;			// Posicin del prximo registro
+static uint8_t secuencia = 0;			// Secuencia del prximo registro
+static uint8_t desdeClave = BITACORA_CLAVE_CADA;	// Fuerza la clave de reloj del arranque
+static uint8_t conocidos = 0;			// Dispositivos con clave de valor vigente (bits)
+static uint32_t ultimoValor[BITACORA_RELOJ];
+static uint32_t ultimoTiempo = 0;		// Unidades de 10 ms
+static uint16_t perdidos = 0;
+
+// Lectura directa (la EEPROM no debe estar escribiendo)
+static uint8_t leerByte(uint16_t direccion)
+{
+	EEAR = direccion;
+	EECR |= (1<<EERE);
+	return EEDR;
+}
+
+void Bitacora_init(void)
+{
+	uint8_t actual, proxima;
+
+	// El ms nuevo es el nico registro escrito cuyo siguiente no contina la
+	// secuencia (256 no es mltiplo de 127, as que tras dar la vuelta al
+	// anillo la secuencia vieja nunca coincide con la esperada)
+	proxima = leerByte(0) & 0x7F;
+	for (uint16_t i = 0; i < BITACORA_REGISTROS; i++)
+	{
+		actual = proxima;
+		proxima = leerByte(((i + 1) % BITACORA_REGISTROS) * 4) & 0x7F;
+		if (actual < SECUENCIAS && proxima != (actual + 1) % SECUENCIAS)
+		{
+			siguiente = i + 1;
+			secuencia = (actual + 1) % SECUENCIAS;
+			return;
+		}
+	}
+	// EEPROM vaca (o sin ningn corte): se empieza desde el principio
+	siguiente = 0;
+	secuencia = 0;
+}
+
+// Agrega un registro a la cola y despierta a la ISR (debe haber lugar)
+static void encolar(uint8_t clave, uint8_t b1, uint8_t b2, uint8_t b3)
+{
+	uint8_t c = colaCabeza;
+
+	cola[c].posicion = siguiente++;
+	cola[c].datos[0] = clave | secuencia;
+	cola[c].datos[1] = b1;
+	cola[c].datos[2] = b2;
+	cola[c].datos[3] = b3;
+	colaCabeza = (c + 1) & BITACORA_MASCARA;
+	secuencia = (secuencia + 1) % SECUENCIAS;
+	if (desdeClave < BITACORA_CLAVE_CADA)
+	{
+		desdeClave++;
+	}
+	EECR |= (1<<EERIE);
+}
+
+static void encolarClave(uint8_t dispositivo, uint32_t v)
+{
+	encolar(CLAVE, (dispositivo << 6) | ((v >> 16) & 0x3F), v >> 8, v);
+}
+
+uint8_t Bitacora_Registrar(uint8_t dispositivo, uint32_t valor, uint32_t ms)
+{
+	uint32_t tiempo = ms / 10;
+	uint32_t dt = tiempo - ultimoTiempo;
+	uint8_t bit = 1 << dispositivo;
+	uint8_t clave, reloj, necesarios;
+	int32_t delta;
+
+	valor &= VALOR_MASCARA;
+	if (desdeClave >= BITACORA_CLAVE_CADA)
+	{
+		conocidos = 0;	// Se repiten todas las claves
+	}
+	if ((conocidos & bit) && valor == ultimoValor[dispositivo])
+	{
+		return 1;		// Sin cambios: no se gasta EEPROM
+	}
+
+	// Diferencia con signo en 22 bits
+	delta = (int32_t)(((valor - ultimoValor[dispositivo]) & VALOR_MASCARA) << 10) >> 10;
+
+	// El delta no entra en 8 bits o el dispositivo no tiene clave vigente
+	clave = !(conocidos & bit) || delta < -128 || delta > 127;
+
+	// Clave de reloj: al empezar cada grupo de claves, si dt no entra en 14 bits
+	// o antes de una clave de valor (que no lleva tiempo) si pas tiempo
+	reloj = !conocidos || dt > DT_MAX || (clave && dt != 0);
+	necesarios = 1 + reloj;
+
+	if (((colaCabeza - colaCola) & BITACORA_MASCARA) + necesarios > BITACORA_MASCARA)
+	{
+		perdidos++;
+		return 0;
+	}
+
+	if (reloj)
+	{
+		if (!conocidos)
+		{
+			desdeClave = 0;
+		}
+		encolarClave(BITACORA_RELOJ, tiempo);
+		ultimoTiempo = tiempo;
+		dt = 0;
+	}
+	if (clave)
+	{
+		encolarClave(dispositivo, valor);
+		conocidos |= bit;
+	}
+	else
+	{
+		encolar(0, (dispositivo << 6) | (dt >> 8), dt, (uint8_t)delta);
+		ultimoTiempo = tiempo;
+	}
+	ultimoValor[dispositivo] = valor;
+	return 1;
+}
+
+uint8_t Bitacora_Leer(uint8_t n, uint8_t *destino)
+{
+	uint8_t listo = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (!(EECR & (1<<EEPE)))
+		{
+			uint16_t direccion = (uint16_t)(uint8_t)(siguiente + n) * 4;
+			for (uint8_t i = 0; i < 4; i++)
+			{
+				destino[i] = leerByte(direccion + i);
+			}
+			listo = 1;
+		}
+	}
+	return listo;
+}
+
+uint16_t Bitacora_Perdidos(void)
+{
+	return perdidos;
+}
+
+// EEPROM lista: escribir el siguiente byte pendiente o apagar la interrupcin
+// si la cola est vaca. El byte 0 primero se marca vaco y se escribe ltimo,
+// as un reset a mitad del registro no deja la secuencia vieja con datos nuevos
+ISR(EE_READY_vect)
+{
+	static const uint8_t orden[5] = {0, 1, 2, 3, 0};
+	uint8_t c = colaCola;
+	uint8_t n, dato;
+
+	if (c == colaCabeza)
+	{
+		EECR &= ~(1<<EERIE);
+		return;
+	}
+	n = orden[byteActual];
+	dato = (byteActual == 0) ? BITACORA_VACIO : cola[c].datos[n];
+	EEAR = (uint16_t)cola[c].posicion * 4 + n;
+	if (++byteActual == 5)
+	{
+		byteActual = 0;
+		colaCola = (c + 1) & BITACORA_MASCARA;
+	}
+
+	// Si la celda ya tiene ese valor no se escribe (ni se desgasta)
+	EECR |= (1<<EERE);
+	if (EEDR != dato)
+	{
+		EEDR = dato;
+		EECR |= (1<<EEMPE);	// EEPE debe escribirse dentro de 4 ciclos
+		EECR |= (1<<EEPE);	// Borrado + escritura (~3.4 ms), la ISR vuelve al terminar
+	}
+}
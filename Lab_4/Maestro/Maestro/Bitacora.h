@@ -0,0 +1,58 @@
+/*
+ * Bitacora.h
+ *
+ * Created: 29/08/2025 08:14:52
+ *  Author: valen
+ */ 
+
+
+#ifndef BITACORA_H_
+#define BITACORA_H_
+
+#include <stdint.h>
+
+// Registro de muestras en la EEPROM (1 KB) que sobrevive a los reset.
+//
+// La EEPROM se usa como un anillo de 256 registros de 4 bytes que se recorre
+// siempre en el mismo sentido, asi cada celda se escribe lo mismo (desgaste
+// parejo). Las escrituras (~3.4 ms por byte) las hace la ISR de EE_READY a
+// partir de una cola en RAM: Bitacora_Registrar nunca espera.
+//
+// Formato de cada registro:
+//   byte 0: bit 7 = clave (1) o delta (0), bits 6..0 = secuencia (0-126)
+//   Delta:  byte 1 = [disp:2][dt bits 13..8], byte 2 = dt bits 7..0,
+//           byte 3 = cambio del valor (i8)
+//   Clave:  byte 1 = [disp:2][v bits 21..16], byte 2 = v bits 15..8, byte 3 = v bits 7..0
+// dt es el tiempo desde el registro anterior en unidades de 10 ms. Una clave
+// con disp = BITACORA_RELOJ fija el tiempo absoluto (ms/10, 22 bits); las
+// demas claves fijan el valor completo (22 bits) de ese dispositivo.
+// 0xFF en el byte 0 (secuencia 0x7F) es un registro vacio. Antes de escribir
+// los bytes 1 a 3 el byte 0 se pone en 0xFF y recien al final recibe la
+// secuencia: un registro cortado por un reset queda vacio, en vez de mezclar
+// la secuencia vieja con datos nuevos.
+//
+// El primer registro despues de cada arranque es una clave de reloj (el
+// tiempo vuelve a empezar: asi se reconocen los reset), y cada
+// BITACORA_CLAVE_CADA registros se repiten las claves para poder decodificar
+// el anillo aunque se haya sobrescrito lo mas viejo.
+#define BITACORA_REGISTROS	256
+#define BITACORA_COLA		16		// Registros esperando la EEPROM (potencia de 2)
+#define BITACORA_CLAVE_CADA	64
+#define BITACORA_RELOJ		3		// Dispositivo reservado para las claves de tiempo
+#define BITACORA_VACIO		0xFF
+
+// Busca la cabeza del anillo (el registro siguiente al mas nuevo)
+void Bitacora_init(void);
+
+// Registra el valor de un dispositivo (0-2) si cambio desde el ultimo registro.
+// Devuelve 0 si se descarto por tener la cola llena
+uint8_t Bitacora_Registrar(uint8_t dispositivo, uint32_t valor, uint32_t ms);
+
+// Copia el registro n (0 = el mas viejo del anillo) en 4 bytes.
+// Devuelve 0 si la EEPROM esta ocupada escribiendo: hay que reintentar
+uint8_t Bitacora_Leer(uint8_t n, uint8_t *destino);
+
+// Registros descartados por tener la cola llena
+uint16_t Bitacora_Perdidos(void);
+
+#endif /* BITACORA_H_ */
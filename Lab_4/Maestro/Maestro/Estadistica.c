@@ -0,0 +1,132 @@
+/*
+ * Estadistica.c
+ *
+ * Created: 09/09/2025 08:13:27
+ *  Author: valen
+ */ 
+
+#include "Estadistica.h"
+
+#define MASCARA (ESTADISTICA_VENTANA - 1)
+
+// Valor de una muestra a partir de su nmero
+#define MUESTRA(e, n) ((e)->muestras[(uint8_t)(n) & MASCARA])
+
+void Estadistica_Iniciar(Estadistica *e)
+{
+	e->siguiente = 0;
+	e->cuenta = 0;
+	e->suma = 0;
+	e->sumaCuadrados = 0;
+	e->minFrente = e->minFinal = 0;
+	e->maxFrente = e->maxFinal = 0;
+}
+
+void Estadistica_Agregar(Estadistica *e, uint32_t valor)
+{
+	uint16_t v = (valor > 0xFFFF) ? 0xFFFF : valor;
+	uint8_t n = e->siguiente;
+	uint16_t viejo;
+
+	// Con la ventana llena sale la muestra n - VENTANA, que ocupa el mismo lugar
+	if (e->cuenta == ESTADISTICA_VENTANA)
+	{
+		viejo = MUESTRA(e, n);
+		e->suma -= viejo;
+		e->sumaCuadrados -= (uint32_t)viejo * viejo;
+
+		// Si todava era candidata, est al frente de su cola
+		if (e->colaMin[e->minFrente & MASCARA] == (uint8_t)(n - ESTADISTICA_VENTANA))
+		{
+			e->minFrente++;
+		}
+		if (e->colaMax[e->maxFrente & MASCARA] == (uint8_t)(n - ESTADISTICA_VENTANA))
+		{
+			e->maxFrente++;
+		}
+	}
+	else
+	{
+		e->cuenta++;
+	}
+
+	MUESTRA(e, n) = v;
+	e->suma += v;
+	e->sumaCuadrados += (uint32_t)v * v;
+
+	// Las muestras que la nueva supera (o iguala) ya no pueden ser el mnimo
+	// ni el mximo mientras ella siga en la ventana
+	while (e->minFinal != e->minFrente && MUESTRA(e, e->colaMin[(uint8_t)(e->minFinal - 1) & MASCARA]) >= v)
+	{
+		e->minFinal--;
+	}
+	e->colaMin[e->minFinal++ & MASCARA] = n;
+
+	while (e->maxFinal != e->maxFrente && MUESTRA(e, e->colaMax[(uint8_t)(e->maxFinal - 1) & MASCARA]) <= v)
+	{
+		e->maxFinal--;
+	}
+	e->colaMax[e->maxFinal++ & MASCARA] = n;
+
+	e->siguiente = n + 1;
+}
+
+// Raz cuadrada entera (bit a bit, sin divisiones)
+static uint16_t raiz(uint32_t x)
+{
+	uint32_t resultado = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > x)
+	{
+		bit >>= 2;
+	}
+	while (bit)
+	{
+		if (x >= resultado + bit)
+		{
+			x -= resultado + bit;
+			resultado = (resultado >> 1) + bit;
+		}
+		else
+		{
+			resultado >>= 1;
+		}
+		bit >>= 2;
+	}
+	return resultado;
+}
+
+void Estadistica_Resultado(const Estadistica *e, EstadisticaResultado *r)
+{
+	uint8_t n = e->cuenta;
+	uint64_t dispersion;
+	uint64_t varianza100;
+
+	r->cuenta = n;
+	if (n == 0)
+	{
+		r->minimo = r->maximo = 0;
+		r->media = 0;
+		r->varianza = 0;
+		r->desvio = 0;
+		return;
+	}
+
+	r->minimo = MUESTRA(e, e->colaMin[e->minFrente & MASCARA]);
+	r->maximo = MUESTRA(e, e->colaMax[e->maxFrente & MASCARA]);
+	r->media = (e->suma * 10 + n / 2) / n;
+
+	// n^2 * varianza = n * sum(x^2) - (sum x)^2, sin cancelacin en enteros
+	dispersion = (uint64_t)n * e->sumaCuadrados - (uint64_t)e->suma * e->suma;
+	varianza100 = dispersion * 100 / ((uint16_t)n * n);
+	r->varianza = (varianza100 / 100 > 0xFFFFFFFF) ? 0xFFFFFFFF : varianza100 / 100;
+	if (varianza100 > 0xFFFFFFFF)
+	{
+		r->desvio = (uint32_t)raiz(r->varianza) * 10; // Sin la dcima
+	}
+	else
+	{
+		r->desvio = raiz(varianza100);
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ * Estadistica.h
+ *
+ * Created: 09/09/2025 08:14:03
+ *  Author: valen
+ */ 
+
+
+#ifndef ESTADISTICA_H_
+#define ESTADISTICA_H_
+
+#include <stdint.h>
+
+// Estadistica movil de un canal sobre las ultimas ESTADISTICA_VENTANA
+// lecturas (con el sondeo adaptativo no son equiespaciadas en el tiempo).
+// Cada muestra nueva actualiza todo en O(1) amortizado:
+//  - suma y suma de cuadrados: se suma la que entra y se resta la que sale
+//  - minimo y maximo: colas monotonas con los numeros de muestra que todavia
+//    pueden ser el minimo (valores crecientes) o el maximo (decrecientes);
+//    el frente de cada cola es el resultado y cada muestra entra y sale una
+//    sola vez
+// Las muestras se limitan a 16 bits.
+
+#define ESTADISTICA_VENTANA	32		// Muestras en la ventana (potencia de 2, hasta 128)
+
+typedef struct
+{
+	uint16_t muestras[ESTADISTICA_VENTANA];	// Anillo; la muestra n esta en n % VENTANA
+	uint8_t siguiente;						// Numero de la proxima muestra (mod 256)
+	uint8_t cuenta;							// Muestras en la ventana
+	uint32_t suma;
+	uint64_t sumaCuadrados;
+	uint8_t colaMin[ESTADISTICA_VENTANA];	// Numeros de muestra, del frente al final
+	uint8_t colaMax[ESTADISTICA_VENTANA];
+	uint8_t minFrente, minFinal;			// Posiciones (mod 256) de cada cola
+	uint8_t maxFrente, maxFinal;
+} Estadistica;
+
+typedef struct
+{
+	uint8_t cuenta;			// Muestras usadas (0 = sin datos, el resto vale 0)
+	uint16_t minimo;
+	uint16_t maximo;
+	uint32_t media;			// Decimas
+	uint32_t varianza;		// Unidades al cuadrado (poblacional, saturada en 32 bits)
+	uint32_t desvio;		// Decimas
+} EstadisticaResultado;
+
+// Vacia la ventana
+void Estadistica_Iniciar(Estadistica *e);
+
+// Agrega una muestra (valores mayores que 0xFFFF se guardan como 0xFFFF)
+void Estadistica_Agregar(Estadistica *e, uint32_t valor);
+
+// Calcula media, varianza y desvio a partir de las sumas (una division
+// y una raiz cuadrada: llamarla solo cuando se va a mostrar o enviar)
+void Estadistica_Resultado(const Estadistica *e, EstadisticaResultado *r);
+
+#endif /* ESTADISTICA_H_ */
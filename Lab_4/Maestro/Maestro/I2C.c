@@ -6,6 +6,8 @@
  */
 
 #include "I2C.h"  // Inclusin del archivo de cabecera con las declaraciones de funciones y definiciones
+#include "Timer.h" // micros() para la sincronizacin de los esclavos
+#include "Traza.h" // Registro opcional de los estados del TWI (TRAZA_TWI)
 
 //***************************************************************
 // Funcin para inicializar I2C en modo Maestro
@@ -17,45 +19,47 @@ void I2C_Master_Init(unsigned long SCL_Clock, uint8_t Prescaler) {
     // Configura el prescaler para el bit rate
     switch (Prescaler) {
         case 1:
-            TWSR0 &= ~((1 << TWPS1) | (1 << TWPS0)); // Prescaler = 1
+            TWI_TWSR &= ~((1 << TWPS1) | (1 << TWPS0)); // Prescaler = 1
             break;
         case 4:
-            TWSR0 &= ~(1 << TWPS1);  // Prescaler = 4
-            TWSR0 |= (1 << TWPS0);
+            TWI_TWSR &= ~(1 << TWPS1);  // Prescaler = 4
+            TWI_TWSR |= (1 << TWPS0);
             break;
         case 16:
-            TWSR0 &= ~(1 << TWPS0);  // Prescaler = 16
-            TWSR0 |= (1 << TWPS1);
+            TWI_TWSR &= ~(1 << TWPS0);  // Prescaler = 16
+            TWI_TWSR |= (1 << TWPS1);
             break;
         case 64:
-            TWSR0 |= (1 << TWPS1) | (1 << TWPS0);  // Prescaler = 64
+            TWI_TWSR |= (1 << TWPS1) | (1 << TWPS0);  // Prescaler = 64
             break;
 		default:
-			TWSR0 &= ~((1 << TWPS1) | (1 << TWPS0)); // Si se pasa otro valor, usa 1 como predeterminado
+			TWI_TWSR &= ~((1 << TWPS1) | (1 << TWPS0)); // Si se pasa otro valor, usa 1 como predeterminado
 			Prescaler = 1;
 			break;
     }
 
-    // Configura el Bit Rate Register (TWBR0) segn la frecuencia de CPU y prescaler
-    // TWBR0 debe ser mayor a 10 para funcionamiento estable
-	TWBR0 = (((16000000)/SCL_Clock) - 16) / (2 * Prescaler); 
+    // Configura el Bit Rate Register (TWBR) segn la frecuencia de CPU y prescaler
+    // TWBR debe ser mayor a 10 para funcionamiento estable
+	TWI_TWBR = (((16000000)/SCL_Clock) - 16) / (2 * Prescaler); 
 
-	TWCR0 |= (1 << TWEN);  // Habilita la interfaz TWI (I2C)
+	TWI_TWCR |= (1 << TWEN);  // Habilita la interfaz TWI (I2C)
 }
 
 //************************************************************************
 // Funcin que inicia la comunicacin I2C (Start condition)
 //************************************************************************
 void I2C_Master_Start(void){
-    TWCR0 = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN); // Genera condicin START y habilita TWI
-    while (!(TWCR0 & (1 << TWINT))); // Espera hasta que la condicin START se haya transmitido
+    TWI_TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN); // Genera condicin START y habilita TWI
+    TWI_Esperar(); // Espera hasta que la condicin START se haya transmitido
+    TRAZA(TWI_Estado(), 0);          // TWI_START o TWI_START_REPETIDO
 }
 
 //************************************************************************
 // Funcin que detiene la comunicacin I2C (Stop condition)
 //************************************************************************
 void I2C_Master_Stop(void){
-    TWCR0 = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO); // Genera condicin STOP
+    TWI_TWCR = (1 << TWEN) | (1 << TWINT) | (1 << TWSTO); // Genera condicin STOP
+    TRAZA(TRAZA_STOP, 0);
 }
 
 //************************************************************************
@@ -65,15 +69,16 @@ void I2C_Master_Stop(void){
 uint8_t I2C_Master_Write(uint8_t dato){
     uint8_t estado;
 
-    TWDR0 = dato;  // Carga el dato en el registro de datos TWI
-    TWCR0 = (1 << TWEN) | (1 << TWINT); // Inicia la transmisin del dato
+    TWI_TWDR = dato;  // Carga el dato en el registro de datos TWI
+    TWI_TWCR = (1 << TWEN) | (1 << TWINT); // Inicia la transmisin del dato
 
-    while (!(TWCR0 & (1 << TWINT))); // Espera a que se complete la transmisin
+    TWI_Esperar(); // Espera a que se complete la transmisin
 
-    estado = TWSR0 & 0xF8; // Extrae el cdigo de estado del TWSR
+    estado = TWI_Estado(); // Extrae el cdigo de estado del TWI_TWSR
+    TRAZA(estado, dato);
 
     // Verifica si el dato fue transmitido correctamente y se recibi ACK
-    if (estado == 0x18 || estado == 0x28 || estado == 0x40) {
+    if (estado == TWI_MT_SLA_ACK || estado == TWI_MT_DATO_ACK || estado == TWI_MR_SLA_ACK) {
         return 1; // xito
     } else {
         return estado; // Error, devuelve cdigo de estado
@@ -88,35 +93,145 @@ uint8_t I2C_Master_Write(uint8_t dato){
 uint8_t I2C_Master_Read(uint8_t *buffer, uint8_t ack){
     uint8_t estado;
     
+    // TWEA y TWINT se escriben juntos: con TWINT en 1, cualquier escritura
+    // previa de TWCR ya arrancara la recepcin
     if (ack) {
-        TWCR0 |= (1 << TWEA);  // Habilita envo de ACK tras recibir dato
+        TWI_TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA); // Recibe y responde con ACK
     } else {
-        TWCR0 &= ~(1 << TWEA); // Deshabilita ACK (se enva NACK)
+        TWI_TWCR = (1 << TWINT) | (1 << TWEN);               // Recibe y responde con NACK (ltimo dato)
     }
 
-    TWCR0 |= (1 << TWINT); // Inicia recepcin del dato
-    while (!(TWCR0 & (1 << TWINT))); // Espera a que se reciba el dato
+    TWI_Esperar(); // Espera a que se reciba el dato
 
-    estado = TWSR0 & 0xF8; // Extrae cdigo de estado
+    estado = TWI_Estado(); // Extrae cdigo de estado
+    TRAZA(estado, TWI_TWDR);
 
     // Si el estado indica que se recibi el dato correctamente (con o sin ACK)
-    if (estado == 0x58 || estado == 0x50) {
-        *buffer = TWDR0;  // Guarda el dato recibido en el puntero proporcionado
+    if (estado == TWI_MR_DATO_NACK || estado == TWI_MR_DATO_ACK) {
+        *buffer = TWI_TWDR;  // Guarda el dato recibido en el puntero proporcionado
         return 1;         // xito
     } else {
         return estado;    // Error
     }
 }
 
+//************************************************************************
+// Funcin para comprobar si un esclavo est presente en el bus
+// Solo enva la direccin con escritura y un STOP (no cambia su estado)
+// Retorna 1 si el esclavo respondi con ACK, 0 si no
+//************************************************************************
+uint8_t I2C_Master_Probar(uint8_t direccion){
+    uint8_t estado;
+
+    I2C_Master_Start();
+    estado = I2C_Master_Write(direccion << 1);
+    I2C_Master_Stop();
+    while (TWI_TWCR & (1 << TWSTO));
+
+    return estado == 1;
+}
+
+//************************************************************************
+// Funcin para enviar un comando a todos los esclavos por llamada general
+// Una sola transaccin reemplaza un comando por cada esclavo
+// Retorna 1 si algn esclavo respondi con ACK, o el cdigo de estado si no
+//************************************************************************
+uint8_t I2C_Master_Broadcast(uint8_t comando){
+    uint8_t estado;
+
+    I2C_Master_Start();
+    estado = I2C_Master_Write(I2C_LLAMADA_GENERAL << 1); // Direccin 0x00 + escritura
+    if (estado == 1) {
+        estado = I2C_Master_Write(comando); // Comando comn para todos los esclavos
+    }
+    I2C_Master_Stop();
+    while (TWI_TWCR & (1 << TWSTO)); // Espera a que el STOP salga antes de la siguiente transaccin
+
+    return estado;
+}
+
+//************************************************************************
+// Funcin para sincronizar el reloj de todos los esclavos (llamada general)
+// El tiempo se toma justo despus del ACK del comando, que es cuando los
+// esclavos toman su propio tiempo local (en la interrupcin de ese byte)
+// Retorna 1 si algn esclavo recibi el tiempo completo, o el cdigo de estado
+//************************************************************************
+uint8_t I2C_Master_Sincronizar(void){
+    uint8_t estado;
+    uint32_t tiempo;
+
+    I2C_Master_Start();
+    estado = I2C_Master_Write(I2C_LLAMADA_GENERAL << 1); // Direccin 0x00 + escritura
+    if (estado == 1) {
+        estado = I2C_Master_Write(I2C_CMD_TIEMPO);
+    }
+    tiempo = micros();
+    for (uint8_t i = 0; estado == 1 && i < 4; i++) {
+        estado = I2C_Master_Write(tiempo >> (8 * i)); // Little-endian
+    }
+    I2C_Master_Stop();
+    while (TWI_TWCR & (1 << TWSTO)); // Espera a que el STOP salga antes de la siguiente transaccin
+
+    return estado;
+}
+
+//************************************************************************
+// Funcin para leer n registros consecutivos de un esclavo
+// Escribe el nmero de registro y, con START repetido, lee los datos
+// (ACK en todos menos el ltimo). Retorna 1 si hay xito, o el cdigo de estado
+//************************************************************************
+uint8_t I2C_Master_Leer_Registros(uint8_t direccion, uint8_t registro, uint8_t *datos, uint8_t n){
+    uint8_t estado;
+
+    I2C_Master_Start();
+    estado = I2C_Master_Write(direccion << 1); // Direccin + escritura
+    if (estado == 1) {
+        estado = I2C_Master_Write(registro);    // Puntero de registro del esclavo
+    }
+    if (estado == 1) {
+        I2C_Master_Start();                     // START repetido
+        estado = I2C_Master_Write((direccion << 1) | 1); // Direccin + lectura
+    }
+    for (uint8_t i = 0; estado == 1 && i < n; i++) {
+        estado = I2C_Master_Read(&datos[i], i < n - 1);
+    }
+    I2C_Master_Stop();
+    while (TWI_TWCR & (1 << TWSTO)); // Espera a que el STOP salga antes de la siguiente transaccin
+
+    return estado;
+}
+
+//************************************************************************
+// Funcin para escribir un byte en un registro de un esclavo
+// Retorna 1 si hay xito, o el cdigo de estado si hay error
+//************************************************************************
+uint8_t I2C_Master_Escribir_Registro(uint8_t direccion, uint8_t registro, uint8_t dato){
+    uint8_t estado;
+
+    I2C_Master_Start();
+    estado = I2C_Master_Write(direccion << 1); // Direccin + escritura
+    if (estado == 1) {
+        estado = I2C_Master_Write(registro);    // Puntero de registro del esclavo
+    }
+    if (estado == 1) {
+        estado = I2C_Master_Write(dato);
+    }
+    I2C_Master_Stop();
+    while (TWI_TWCR & (1 << TWSTO)); // Espera a que el STOP salga antes de la siguiente transaccin
+
+    return estado;
+}
+
 //*****************************************************************************
 // Funcin para inicializar I2C en modo Esclavo con una direccin especfica
 //*****************************************************************************
 void I2C_Slave_Init(uint8_t address) {
     DDRC &= ~((1 << DDC4) | (1 << DDC5));  // Configura los pines SDA y SCL como entradas
 
-    TWAR0 = address << 1;  // Asigna la direccin del esclavo (7 bits alineados a la izquierda)
-    // TWAR = (address << 1 | 0x01);  // Alternativa: permite direccin general
+    // Asigna la direccin del esclavo (7 bits alineados a la izquierda) y
+    // habilita el reconocimiento de la llamada general (TWGCE)
+    TWI_TWAR = (address << 1) | (1 << TWGCE);
 
     // Habilita: interfaz TWI, reconocimiento automtico de direcciones (ACK), interrupcin de TWI
-    TWCR0 = (1 << TWEA) | (1 << TWEN) | (1 << TWIE);
+    TWI_TWCR = (1 << TWEA) | (1 << TWEN) | (1 << TWIE);
 }
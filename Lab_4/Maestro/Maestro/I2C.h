@@ -11,6 +11,17 @@
 
 #include <avr/io.h>
 #include <stdint.h>
+#include "../../HAL/TWI.h" // Registros y estados del TWI comunes a los tres nodos
+
+// Direccion de llamada general (todos los esclavos con TWGCE la reconocen)
+#define I2C_LLAMADA_GENERAL 0x00
+
+// Comando de llamada general: cada esclavo congela (latch) su dato en el mismo instante
+#define I2C_CMD_LATCH 'S'
+
+// Comando de llamada general para sincronizar los relojes: le siguen 4 bytes con
+// el tiempo del maestro (us, little-endian) tomado al recibir el ACK del comando
+#define I2C_CMD_TIEMPO 'T'
 
 // Funcion para inicializar I2C Maestro
 void I2C_Master_Init(unsigned long SCL_Clock, uint8_t Prescaler);
@@ -29,6 +40,26 @@ uint8_t I2C_Master_Write(uint8_t dato);
 // (Lee los datos que estan en el esclavo)
 uint8_t I2C_Master_Read(uint8_t *buffer, uint8_t ack);
 
+// Funcion para leer n registros consecutivos de un esclavo a partir de "registro"
+// (Devuelve 1 si la lectura fue completa)
+uint8_t I2C_Master_Leer_Registros(uint8_t direccion, uint8_t registro, uint8_t *datos, uint8_t n);
+
+// Funcion para escribir un byte en un registro de un esclavo
+// (Devuelve 1 si el esclavo recibio los tres bytes)
+uint8_t I2C_Master_Escribir_Registro(uint8_t direccion, uint8_t registro, uint8_t dato);
+
+// Funcion para comprobar si un esclavo responde en una direccion
+// (Devuelve 1 si hubo ACK)
+uint8_t I2C_Master_Probar(uint8_t direccion);
+
+// Funcion para enviar un comando por llamada general a todos los esclavos
+// (Devuelve 1 si al menos un esclavo reconocio la llamada)
+uint8_t I2C_Master_Broadcast(uint8_t comando);
+
+// Funcion para enviar el tiempo del maestro (micros) a todos los esclavos
+// (Devuelve 1 si al menos un esclavo recibio el tiempo completo)
+uint8_t I2C_Master_Sincronizar(void);
+
 // Funcion para inicializar I2C Esclavo
 void I2C_Slave_Init(uint8_t address);
 
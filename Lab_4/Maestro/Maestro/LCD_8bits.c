@@ -16,29 +16,33 @@
 // E: PB3
 
 void initLCD8(void){
+	LCD8_Pines();
+	_delay_ms(LCD8_ENCENDIDO_MS);
+	LCD8_Configurar();
+}
+
+void LCD8_Pines(void){
 	// Configurar pines de datos PD2-PD7 como salidas
 	DDRD |= 0b11111100; // PD2, PD3, PD4, PD5, PD6, PD7
 	
 	// Configurar pines PB0, PB1 (datos), PB2 (RS), PB3 (E) como salidas
 	DDRB |= 0b00001111; // PB0, PB1, PB2, PB3
-	
-	_delay_ms(15);
-	
+}
+
+// Secuencia de configuracin: debe llamarse al menos LCD8_ENCENDIDO_MS
+// despus de alimentar el LCD (unos 2.2 ms en total)
+void LCD8_Configurar(void){
 	// Function SET (8 bits, 2 lneas, 5x8 dots)
 	LCD8_CMD(0b00111000);
-	_delay_ms(5);
 	
 	// Display ON/OFF (Display ON, Cursor OFF, Blink OFF)
 	LCD8_CMD(0b00001100);
-	_delay_ms(2);
 	
 	// Entry mode (Increment cursor, no shift)
 	LCD8_CMD(0b00000110);
-	_delay_ms(2);
 	
 	// Clear display
-	LCD8_CMD(0b00000001);
-	_delay_ms(2);
+	LCD8_Clear();
 }
 
 void LCD8_PORT(uint8_t data) {
@@ -54,9 +58,9 @@ void LCD8_PORT(uint8_t data) {
 	
 	// Pulso de Enable
 	PORTB |= (1 << 3);   // E = 1
-	_delay_ms(1);
+	_delay_us(1);        // Ancho mnimo de E: 450 ns
 	PORTB &= ~(1 << 3);  // E = 0
-	_delay_ms(1);
+	_delay_us(LCD8_INSTRUCCION_US);
 }
 
 void LCD8_CMD(uint8_t data){
@@ -72,9 +76,9 @@ void LCD8_CMD(uint8_t data){
 	
 	// Pulso de Enable
 	PORTB |= (1 << 3);   // E = 1
-	_delay_ms(1);
+	_delay_us(1);        // Ancho mnimo de E: 450 ns
 	PORTB &= ~(1 << 3);  // E = 0
-	_delay_ms(1);
+	_delay_us(LCD8_INSTRUCCION_US); // La mayora de instrucciones tardan 37 us
 }
 
 void LCD8_Write_Char(char c){
@@ -90,9 +94,9 @@ void LCD8_Write_Char(char c){
 	
 	// Pulso de Enable
 	PORTB |= (1 << 3);   // E = 1
-	_delay_ms(1);
+	_delay_us(1);
 	PORTB &= ~(1 << 3);  // E = 0
-	_delay_ms(1);
+	_delay_us(LCD8_INSTRUCCION_US);
 }
 
 void LCD8_Write_String(char *a){
@@ -128,6 +132,12 @@ void LCD8_Variable_U(uint8_t v){
 	LCD8_Write_String(str);
 }
 
+void LCD8_Variable_U32(uint32_t v){
+	char str[11];
+	uint32_to_string(v, str);
+	LCD8_Write_String(str);
+}
+
 void float_to_string(float num, char *buffer, uint8_t decimales) {
 	int parte_entera = (int)num;
 	int parte_decimal = (int)((num - parte_entera) * 100);
@@ -173,4 +183,158 @@ void uint8_to_string(uint8_t num, char *buffer) {
 		}
 	}
 	buffer[i] = '\0';
+}
+
+void uint32_to_string(uint32_t num, char *buffer) {
+	uint8_t i = 0;
+	char temp[10];
+	uint8_t j = 0;
+	
+	if (num == 0) {
+		buffer[i++] = '0';
+		} else {
+		while (num > 0) {
+			temp[j++] = (num % 10) + '0';
+			num /= 10;
+		}
+		while (j > 0) {
+			buffer[i++] = temp[--j];
+		}
+	}
+	buffer[i] = '\0';
+}
+
+//************************************************************************
+// Grficos con caracteres propios (CGRAM)
+//************************************************************************
+
+#define LCD8_SIN_DIBUJAR 0xFE  // Valor de sombra que nunca coincide: obliga a escribir
+#define LCD8_SIN_DATO    0xFF  // Columna de la grfica todava sin muestra
+
+static char sombraBarra[2][LCD8_COLUMNAS];            // Caracteres en pantalla de cada fila de barra
+static uint8_t graficaMuestras[LCD8_GRAFICA_ANCHO];   // Alturas, de la ms vieja a la ms nueva
+static uint8_t sombraGlifos[LCD8_GRAFICA_CELDAS][8];  // Filas de pixeles cargadas en la CGRAM
+
+// Escribe n filas de pixeles seguidas en la CGRAM (la direccin se incrementa sola)
+static void LCD8_CGRAM(uint8_t direccion, const uint8_t *filas, uint8_t n){
+	LCD8_CMD(0x40 | (direccion & 0x3F)); // Set CGRAM address
+	for (uint8_t i = 0; i < n; i++) {
+		LCD8_Write_Char(filas[i]);
+	}
+}
+
+void LCD8_Barra_Iniciar(void){
+	uint8_t glifo[8];
+
+	// Glifo g = g + 1 columnas llenas desde la izquierda (0x10, 0x18, 0x1C, 0x1E)
+	for (uint8_t g = 0; g < 4; g++) {
+		for (uint8_t i = 0; i < 8; i++) {
+			glifo[i] = (0x1F << (4 - g)) & 0x1F;
+		}
+		LCD8_CGRAM(g * 8, glifo, 8);
+	}
+	for (uint8_t f = 0; f < 2; f++) {
+		for (uint8_t col = 0; col < LCD8_COLUMNAS; col++) {
+			sombraBarra[f][col] = LCD8_SIN_DIBUJAR;
+		}
+	}
+}
+
+void LCD8_Barra(uint8_t fila, uint16_t valor, uint16_t maximo){
+	uint8_t niveles;
+	uint8_t cursor = 0xFF; // Columna donde qued el cursor del LCD (0xFF = desconocida)
+	char c;
+
+	fila &= 1;
+	if (maximo == 0) maximo = 1;
+	if (valor > maximo) valor = maximo;
+	niveles = ((uint32_t)valor * (LCD8_COLUMNAS * 5) + maximo / 2) / maximo;
+
+	for (uint8_t col = 0; col < LCD8_COLUMNAS; col++) {
+		if (niveles >= 5) {
+			c = 0xFF;              // Celda llena: bloque de la ROM del LCD
+			niveles -= 5;
+		} else if (niveles > 0) {
+			c = niveles - 1;       // Celda parcial: glifo de 1 a 4 columnas
+			niveles = 0;
+		} else {
+			c = ' ';
+		}
+
+		// Solo las celdas distintas; las seguidas no necesitan mover el cursor
+		if (sombraBarra[fila][col] != c) {
+			if (cursor != col) {
+				LCD8_Set_Cursor(col, fila);
+			}
+			LCD8_Write_Char(c);
+			sombraBarra[fila][col] = c;
+			cursor = col + 1;
+		}
+	}
+}
+
+// Arma los 8 glifos a partir de las muestras y enva solo las filas que
+// cambiaron, agrupando las consecutivas en una sola direccin de CGRAM
+static void LCD8_Grafica_Dibujar(void){
+	uint8_t filas[8];
+	uint8_t k, h, anterior, desde, hasta, r, inicio;
+
+	for (uint8_t g = 0; g < LCD8_GRAFICA_CELDAS; g++) {
+		for (r = 0; r < 8; r++) {
+			filas[r] = 0;
+		}
+		for (uint8_t c = 0; c < 5; c++) {
+			k = g * 5 + c;
+			h = graficaMuestras[k];
+			if (h == LCD8_SIN_DATO) continue;
+
+			// Trazo vertical desde la muestra anterior para que la lnea sea continua
+			anterior = (k > 0 && graficaMuestras[k - 1] != LCD8_SIN_DATO) ? graficaMuestras[k - 1] : h;
+			desde = (h < anterior) ? h : anterior;
+			hasta = (h < anterior) ? anterior : h;
+			for (uint8_t y = desde; y <= hasta; y++) {
+				filas[7 - y] |= 0x10 >> c; // Fila 0 = arriba
+			}
+		}
+
+		r = 0;
+		while (r < 8) {
+			if (filas[r] == sombraGlifos[g][r]) {
+				r++;
+				continue;
+			}
+			inicio = r;
+			while (r < 8 && filas[r] != sombraGlifos[g][r]) {
+				sombraGlifos[g][r] = filas[r];
+				r++;
+			}
+			LCD8_CGRAM(g * 8 + inicio, &filas[inicio], r - inicio);
+		}
+	}
+}
+
+void LCD8_Grafica_Iniciar(uint8_t col, uint8_t fila){
+	for (uint8_t k = 0; k < LCD8_GRAFICA_ANCHO; k++) {
+		graficaMuestras[k] = LCD8_SIN_DATO;
+	}
+	for (uint8_t g = 0; g < LCD8_GRAFICA_CELDAS; g++) {
+		for (uint8_t r = 0; r < 8; r++) {
+			sombraGlifos[g][r] = LCD8_SIN_DIBUJAR;
+		}
+	}
+	LCD8_Grafica_Dibujar(); // Glifos en blanco antes de mostrarlos
+
+	LCD8_Set_Cursor(col, fila);
+	for (uint8_t g = 0; g < LCD8_GRAFICA_CELDAS; g++) {
+		LCD8_Write_Char(g);
+	}
+}
+
+void LCD8_Grafica_Agregar(uint8_t altura){
+	if (altura > 7) altura = 7;
+	for (uint8_t k = 0; k < LCD8_GRAFICA_ANCHO - 1; k++) {
+		graficaMuestras[k] = graficaMuestras[k + 1];
+	}
+	graficaMuestras[LCD8_GRAFICA_ANCHO - 1] = altura;
+	LCD8_Grafica_Dibujar();
 }
\ No newline at end of file
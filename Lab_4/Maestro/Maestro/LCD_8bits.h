@@ -14,8 +14,21 @@
 #include <stdio.h>
 #include <util/delay.h>
 
+// Espera tras alimentar el LCD antes de la primera instruccion
+#define LCD8_ENCENDIDO_MS 15
+
+// Espera despues de cada instruccion o caracter (37 us en la hoja de datos + margen)
+#define LCD8_INSTRUCCION_US 50
+
+// Inicializacion bloqueante (pines + espera de encendido + configuracion)
 void initLCD8(void);
 
+// Inicializacion en dos partes, para aprovechar la espera de encendido:
+// LCD8_Pines() al arrancar y LCD8_Configurar() cuando pasen LCD8_ENCENDIDO_MS
+void LCD8_Pines(void);
+
+void LCD8_Configurar(void);
+
 void LCD8_PORT(uint8_t data);
 
 void LCD8_CMD(uint8_t data);
@@ -32,10 +45,39 @@ void LCD8_Variable(float v, uint8_t n);
 
 void LCD8_Variable_U(uint8_t v);
 
+void LCD8_Variable_U32(uint32_t v);
+
 void float_to_string(float num, char *buffer, uint8_t decimales);
 
 void uint8_to_string(uint8_t num, char *buffer);
 
+void uint32_to_string(uint32_t num, char *buffer);
+
+// ---- Graficos con caracteres propios (CGRAM) ----
+// El HD44780 tiene 8 caracteres programables (codigos 0-7): la barra usa 4
+// (0-3) y la grafica los 8, por eso solo puede haber uno de los dos modos en
+// pantalla. Ambos guardan una copia de lo que hay en el LCD y solo envian las
+// celdas o filas de glifo que cambiaron.
+// Despues de dibujar hay que volver a posicionar el cursor con LCD8_Set_Cursor.
+
+#define LCD8_COLUMNAS		16
+#define LCD8_GRAFICA_CELDAS	8		// Glifos de la grafica
+#define LCD8_GRAFICA_ANCHO	(LCD8_GRAFICA_CELDAS * 5)	// Muestras visibles (1 por columna de pixeles)
+
+// Carga los glifos de la barra (1 a 4 columnas llenas) y olvida lo dibujado
+void LCD8_Barra_Iniciar(void);
+
+// Barra horizontal de 16 celdas con 5 pasos por celda (80 niveles):
+// valor de 0 a maximo
+void LCD8_Barra(uint8_t fila, uint16_t valor, uint16_t maximo);
+
+// Borra la grafica y escribe los codigos 0-7 desde (col, fila)
+void LCD8_Grafica_Iniciar(uint8_t col, uint8_t fila);
+
+// Desplaza la grafica una columna a la izquierda y agrega "altura" (0-7)
+// a la derecha; solo se reescriben las filas de glifo que cambiaron
+void LCD8_Grafica_Agregar(uint8_t altura);
+
 
 
 
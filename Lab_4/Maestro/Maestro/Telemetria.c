@@ -0,0 +1,166 @@
+/*
+ * Telemetria.c
+ *
+ * Created: 18/08/2025 10:05:21
+ *  Author: valen
+ */ 
+
+#include "Telemetria.h"
+#include "UART.h"
+
+static uint16_t descartadas = 0;
+
+void Telemetria_init(void)
+{
+	UART_init(TELE_BAUDRATE);
+}
+
+void Telemetria_Enviar(uint8_t tipo, const uint8_t *datos, uint8_t largo)
+{
+	uint8_t trama[TELE_MAX_DATOS + 4];
+	uint8_t chk = tipo ^ largo;
+
+	if (largo > TELE_MAX_DATOS)
+	{
+		return;
+	}
+
+	trama[0] = TELE_SYNC;
+	trama[1] = tipo;
+	trama[2] = largo;
+	for (uint8_t i = 0; i < largo; i++)
+	{
+		trama[3 + i] = datos[i];
+		chk ^= datos[i];
+	}
+	trama[3 + largo] = chk;
+
+	// La trama entra completa o no entra: nunca se espera al UART
+	if (!UART_Escribir(trama, largo + 4))
+	{
+		descartadas++;
+	}
+}
+
+// Guarda un valor de 32 bits en little-endian
+static void guardar_u32(uint8_t *destino, uint32_t valor)
+{
+	destino[0] = valor;
+	destino[1] = valor >> 8;
+	destino[2] = valor >> 16;
+	destino[3] = valor >> 24;
+}
+
+void Telemetria_Muestra(uint32_t tiempo, uint8_t direccion, uint8_t registro, uint32_t valor)
+{
+	uint8_t datos[10];
+
+	guardar_u32(&datos[0], tiempo);
+	datos[4] = direccion;
+	datos[5] = registro;
+	guardar_u32(&datos[6], valor);
+	Telemetria_Enviar(TELE_MUESTRA, datos, sizeof(datos));
+}
+
+void Telemetria_Arranque(uint16_t tiempo, uint8_t causaReset, uint8_t esclavos)
+{
+	uint8_t datos[4];
+
+	datos[0] = tiempo;
+	datos[1] = tiempo >> 8;
+	datos[2] = causaReset;
+	datos[3] = esclavos;
+	Telemetria_Enviar(TELE_ARRANQUE, datos, sizeof(datos));
+}
+
+void Telemetria_Traza(uint8_t nodo, uint8_t indice, const uint8_t *evento)
+{
+	uint8_t datos[TELE_TRAZA_LARGO];
+
+	datos[0] = nodo;
+	datos[1] = indice;
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		datos[2 + i] = evento[i];
+	}
+	Telemetria_Enviar(TELE_TRAZA, datos, sizeof(datos));
+}
+
+void Telemetria_Tiempo(uint8_t direccion, uint32_t latencia, int32_t desfase)
+{
+	uint8_t datos[9];
+
+	datos[0] = direccion;
+	guardar_u32(&datos[1], latencia);
+	guardar_u32(&datos[5], (uint32_t)desfase);
+	Telemetria_Enviar(TELE_TIEMPO, datos, sizeof(datos));
+}
+
+void Telemetria_Bitacora(uint8_t indice, const uint8_t *registro)
+{
+	uint8_t datos[TELE_BITACORA_LARGO];
+
+	datos[0] = indice;
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		datos[1 + i] = registro[i];
+	}
+	Telemetria_Enviar(TELE_BITACORA, datos, sizeof(datos));
+}
+
+void Telemetria_Evento(uint8_t direccion, uint8_t tipo, uint16_t valor, uint32_t tiempo)
+{
+	uint8_t datos[8];
+
+	datos[0] = direccion;
+	datos[1] = tipo;
+	datos[2] = valor;
+	datos[3] = valor >> 8;
+	guardar_u32(&datos[4], tiempo);
+	Telemetria_Enviar(TELE_EVENTO, datos, sizeof(datos));
+}
+
+void Telemetria_Memoria(uint8_t nodo, uint16_t estatica, uint16_t pilaMaxima, uint16_t libre)
+{
+	uint8_t datos[TELE_MEMORIA_LARGO];
+
+	datos[0] = nodo;
+	datos[1] = estatica;
+	datos[2] = estatica >> 8;
+	datos[3] = pilaMaxima;
+	datos[4] = pilaMaxima >> 8;
+	datos[5] = libre;
+	datos[6] = libre >> 8;
+	Telemetria_Enviar(TELE_MEMORIA, datos, sizeof(datos));
+}
+
+void Telemetria_Estadistica(uint8_t direccion, const EstadisticaResultado *r)
+{
+	uint8_t datos[18];
+
+	datos[0] = direccion;
+	datos[1] = r->cuenta;
+	datos[2] = r->minimo;
+	datos[3] = r->minimo >> 8;
+	datos[4] = r->maximo;
+	datos[5] = r->maximo >> 8;
+	guardar_u32(&datos[6], r->media);
+	guardar_u32(&datos[10], r->varianza);
+	guardar_u32(&datos[14], r->desvio);
+	Telemetria_Enviar(TELE_ESTADISTICA, datos, sizeof(datos));
+}
+
+void Telemetria_Deriva(uint8_t direccion, int16_t deriva)
+{
+	uint8_t datos[3];
+
+	datos[0] = direccion;
+	datos[1] = (uint16_t)deriva;
+	datos[2] = (uint16_t)deriva >> 8;
+	Telemetria_Enviar(TELE_DERIVA, datos, sizeof(datos));
+}
+
+uint16_t Telemetria_Descartadas(void)
+{
+	return descartadas;
+}
@@ -0,0 +1,113 @@
+/*
+ * Telemetria.h
+ *
+ * Created: 18/08/2025 10:05:48
+ *  Author: valen
+ */ 
+
+
+#ifndef TELEMETRIA_H_
+#define TELEMETRIA_H_
+
+#include <stdint.h>
+#include "Estadistica.h"
+
+// Formato de trama binaria (todos los campos multibyte en little-endian):
+//
+//   [0xA5] [tipo] [largo] [datos ... (largo bytes)] [chk]
+//
+// chk es el XOR de tipo, largo y todos los bytes de datos. El decodificador
+// de Herramientas/telemetria_csv.c se resincroniza buscando 0xA5 y descarta
+// las tramas con chk incorrecto.
+#define TELE_SYNC		0xA5
+#define TELE_MAX_DATOS	24
+
+// Tipo 0x01 - Muestra (10 bytes):
+//   tiempo_us (u32), direccion esclavo (u8), registro (u8), valor (u32)
+//   tiempo_us es el reloj de red (el del maestro) en que el esclavo tomo la muestra
+#define TELE_MUESTRA	0x01
+
+// Tipo 0x02 - Arranque (4 bytes), una vez despues de cada reset:
+//   ms hasta la primera muestra valida en pantalla (u16), causa del reset (MCUSR, u8),
+//   esclavos detectados (u8, bit 0 = contador, bit 1 = ADC)
+#define TELE_ARRANQUE	0x02
+
+// Tipo 0x03 - Evento de traza del TWI (6 bytes), al volcar la traza con 'T' por RX:
+//   nodo (direccion I2C, 0 = maestro), indice (0 = mas antiguo),
+//   marca de tiempo (u16: ms mod 256 en el byte alto, cuentas de 4 us en el bajo),
+//   estado del TWI (u8), dato (u8)
+#define TELE_TRAZA		0x03
+#define TELE_TRAZA_LARGO 6
+
+// Tipo 0x04 - Tiempos de un esclavo (9 bytes), al mostrar un valor nuevo:
+//   direccion esclavo (u8), latencia desde la muestra hasta el display en us (u32),
+//   desfase de su reloj respecto del maestro en el ultimo latch en us (i32)
+#define TELE_TIEMPO		0x04
+
+// Tipo 0x05 - Registro de la bitacora en EEPROM (5 bytes), al volcarla con 'E' por RX:
+//   indice (u8, 0 = el mas viejo), registro tal como esta en la EEPROM (4 bytes, ver Bitacora.h)
+#define TELE_BITACORA	0x05
+#define TELE_BITACORA_LARGO 5
+
+// Tipo 0x06 - Evento de umbral de un esclavo (8 bytes):
+//   direccion esclavo (u8), tipo (u8, EV_... en Eventos.h del esclavo 2),
+//   valor (u16), tiempo de red en us (u32)
+#define TELE_EVENTO		0x06
+
+// Tipo 0x07 - Uso de la SRAM de un nodo (7 bytes), cada MEMORIA_MS:
+//   nodo (direccion I2C, 0 = maestro), bytes de .data + .bss (u16),
+//   maxima profundidad de la pila desde el reset (u16), bytes nunca usados (u16)
+#define TELE_MEMORIA	0x07
+#define TELE_MEMORIA_LARGO 7
+
+// Tipo 0x08 - Estadistica movil de un esclavo (18 bytes), cada ESTADISTICA_MS:
+//   direccion esclavo (u8), muestras en la ventana (u8), minimo (u16), maximo (u16),
+//   media en decimas (u32), varianza (u32), desvio en decimas (u32); del esclavo
+//   0x30 fuera de MODO_BOTONES son los incrementos de la cuenta entre lecturas
+#define TELE_ESTADISTICA 0x08
+
+// Tipo 0x09 - Deriva del reloj de un esclavo (3 bytes), despues de cada sincronizacion:
+//   direccion esclavo (u8), correccion de frecuencia en decimas de ppm (i16,
+//   positiva = el cristal del esclavo atrasa respecto del maestro)
+#define TELE_DERIVA		0x09
+
+// Baudrate del enlace serie (UBRR = 1 con U2X a 16 MHz)
+#define TELE_BAUDRATE	1000000UL
+
+// Inicializa el UART para telemetria
+void Telemetria_init(void);
+
+// Envia una trama generica; si no cabe en el buffer se descarta
+void Telemetria_Enviar(uint8_t tipo, const uint8_t *datos, uint8_t largo);
+
+// Envia una muestra leida de un esclavo
+void Telemetria_Muestra(uint32_t tiempo, uint8_t direccion, uint8_t registro, uint32_t valor);
+
+// Envia el resumen del arranque
+void Telemetria_Arranque(uint16_t tiempo, uint8_t causaReset, uint8_t esclavos);
+
+// Envia un evento de traza (evento = 4 bytes como los entrega Traza_Leer)
+void Telemetria_Traza(uint8_t nodo, uint8_t indice, const uint8_t *evento);
+
+// Envia la latencia y el desfase de reloj de un esclavo
+void Telemetria_Tiempo(uint8_t direccion, uint32_t latencia, int32_t desfase);
+
+// Envia un registro de la bitacora
+void Telemetria_Bitacora(uint8_t indice, const uint8_t *registro);
+
+// Envia un evento de umbral leido de un esclavo
+void Telemetria_Evento(uint8_t direccion, uint8_t tipo, uint16_t valor, uint32_t tiempo);
+
+// Envia el uso de la SRAM de un nodo
+void Telemetria_Memoria(uint8_t nodo, uint16_t estatica, uint16_t pilaMaxima, uint16_t libre);
+
+// Envia la estadistica de las ultimas lecturas de un esclavo
+void Telemetria_Estadistica(uint8_t direccion, const EstadisticaResultado *r);
+
+// Envia la deriva del reloj de un esclavo
+void Telemetria_Deriva(uint8_t direccion, int16_t deriva);
+
+// Tramas descartadas por falta de espacio en el buffer
+uint16_t Telemetria_Descartadas(void);
+
+#endif /* TELEMETRIA_H_ */
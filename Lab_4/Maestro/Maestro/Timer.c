@@ -0,0 +1,130 @@
+/*
+ * Timer.c
+ *
+ * Created: 18/08/2025 09:01:40
+ *  Author: valen
+ */ 
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "Timer.h"
+
+// Contador de milisegundos que incrementa la ISR del Timer2
+volatile uint32_t timerMilisegundos = 0;
+
+// Diferencia entre el reloj de red y micros() (la fija Timer_Sincronizar)
+static volatile int32_t timerAjuste = 0;
+
+// Correccin de frecuencia: us que se suman a timerAjuste por cada ms, en
+// unidades de 2^-16 us (1 ppm = 65.536). La ISR acumula la parte fraccionaria
+static volatile int32_t timerTasa = 0;
+static uint16_t timerFraccion = 0;
+
+// Sincronizacin anterior, para medir la deriva entre dos sincronizaciones
+static uint32_t sincAnterior;
+static uint8_t sincValida = 0;
+
+void Timer_init(void)
+{
+	TCCR2A = (1<<WGM21);		// Modo CTC (TOP = OCR2A)
+	TCCR2B = (1<<CS22);			// Prescaler 64 -> 16 MHz/64 = 250 kHz (4 us por cuenta)
+	OCR2A = 249;				// 250 cuentas = 1 ms
+	TCNT2 = 0;
+	TIMSK2 |= (1<<OCIE2A);		// Habilitar interrupcion por comparacion
+}
+
+uint32_t millis(void)
+{
+	uint32_t m;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		m = timerMilisegundos;
+	}
+	return m;
+}
+
+uint32_t micros(void)
+{
+	uint32_t m;
+	uint8_t cuentas;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		m = timerMilisegundos;
+		cuentas = TCNT2;
+		// Si el timer ya reinicio pero la ISR aun no corre, sumar ese milisegundo
+		if ((TIFR2 & (1<<OCF2A)) && cuentas < 125)
+		{
+			m++;
+		}
+	}
+	return m * 1000 + (uint16_t)cuentas * 4;
+}
+
+uint32_t Timer_Red(void)
+{
+	int32_t ajuste;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		ajuste = timerAjuste;
+	}
+	return micros() + ajuste;
+}
+
+int32_t Timer_Sincronizar(uint32_t local, uint32_t red)
+{
+	int32_t error;
+	int32_t tasa;
+	uint32_t intervalo = local - sincAnterior;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		error = (int32_t)(red - (local + timerAjuste));
+		timerAjuste = (int32_t)(red - local);	// Salto directo del error acumulado
+		timerFraccion = 0;
+		tasa = timerTasa;
+	}
+
+	// El error acumulado desde la sincronizacin anterior es la deriva que la
+	// correccin de frecuencia todava no compensa. Se corrige 1/4 por vez para
+	// filtrar el ruido de la medicin (unos us por sincronizacin); un error
+	// grande o un intervalo fuera de rango (primera vez, reset) solo hace el salto
+	if (sincValida && intervalo >= TIMER_SINC_MIN_US && intervalo <= TIMER_SINC_MAX_US &&
+	    error > -TIMER_ERROR_MAX_US && error < TIMER_ERROR_MAX_US)
+	{
+		tasa += ((error * 65536L) / (int32_t)(intervalo / 1000)) / 4;
+		if (tasa > TIMER_TASA_MAX) tasa = TIMER_TASA_MAX;
+		if (tasa < -TIMER_TASA_MAX) tasa = -TIMER_TASA_MAX;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			timerTasa = tasa;
+		}
+	}
+	sincAnterior = local;
+	sincValida = 1;
+	return error;
+}
+
+int16_t Timer_Deriva(void)
+{
+	int32_t tasa;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		tasa = timerTasa;
+	}
+	return (tasa * 3125) / 20480;	// 2^-16 us/ms -> 0.1 ppm (10000 / 65536); +-5000 con TIMER_TASA_MAX
+}
+
+ISR(TIMER2_COMPA_vect)
+{
+	uint32_t acumulado;
+
+	timerMilisegundos++;
+
+	// Correccin de frecuencia del reloj de red (0 en el Maestro)
+	if (timerTasa)
+	{
+		acumulado = (uint32_t)timerFraccion + (uint32_t)timerTasa;
+		timerAjuste += (int32_t)acumulado >> 16;
+		timerFraccion = acumulado;
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * Traza.c
+ *
+ * Created: 27/08/2025 07:54:48
+ *  Author: valen
+ */ 
+
+#include "Traza.h"
+
+#ifdef TRAZA_TWI
+
+TrazaEvento trazaBuffer[TRAZA_TAM];
+uint8_t trazaIndice = 0;
+uint8_t trazaCuenta = 0;
+volatile uint8_t trazaActiva = 1;
+
+void Traza_Congelar(uint8_t congelar)
+{
+	trazaActiva = !congelar;
+}
+
+uint8_t Traza_Cuenta(void)
+{
+	return trazaCuenta;
+}
+
+uint8_t Traza_Leer(uint8_t n, uint8_t *destino)
+{
+	TrazaEvento *e;
+
+	if (n >= trazaCuenta)
+	{
+		return 0;
+	}
+	// El mas antiguo esta en trazaIndice si el buffer ya dio la vuelta, o en 0 si no
+	e = &trazaBuffer[(trazaIndice - trazaCuenta + n) & (TRAZA_TAM - 1)];
+	destino[0] = e->tiempo;
+	destino[1] = e->tiempo >> 8;
+	destino[2] = e->estado;
+	destino[3] = e->dato;
+	return 1;
+}
+
+#else
+
+void Traza_Congelar(uint8_t congelar)
+{
+}
+
+uint8_t Traza_Cuenta(void)
+{
+	return 0;
+}
+
+uint8_t Traza_Leer(uint8_t n, uint8_t *destino)
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * UART.c
+ *
+ * Created: 18/08/2025 09:20:10
+ *  Author: valen
+ */ 
+
+#define F_CPU 16000000
+#include <avr/interrupt.h>
+#include "UART.h"
+
+#define UART_TX_MASCARA (UART_TX_TAM - 1)
+
+// Buffer circular: el programa principal escribe en txCabeza, la ISR lee en txCola
+static volatile uint8_t txBuffer[UART_TX_TAM];
+static volatile uint8_t txCabeza = 0;
+static volatile uint8_t txCola = 0;
+
+void UART_init(uint32_t baudrate)
+{
+	UBRR0 = (F_CPU / (8UL * baudrate)) - 1;	// Baudrate en modo doble velocidad
+	UCSR0A = (1<<U2X0);
+	UCSR0B = (1<<TXEN0) | (1<<RXEN0);		// La ISR de TX se habilita al tener datos; RX por consulta
+	UCSR0C = (1<<UCSZ01) | (1<<UCSZ00);		// 8 bits, sin paridad, 1 bit de parada
+}
+
+uint8_t UART_Libre(void)
+{
+	return UART_TX_MASCARA - ((uint8_t)(txCabeza - txCola) & UART_TX_MASCARA);
+}
+
+uint8_t UART_Escribir(const uint8_t *datos, uint8_t n)
+{
+	uint8_t cabeza = txCabeza;
+
+	if (n > UART_Libre())
+	{
+		return 0;	// No hay espacio: se descarta sin esperar
+	}
+
+	for (uint8_t i = 0; i < n; i++)
+	{
+		txBuffer[cabeza] = datos[i];
+		cabeza = (cabeza + 1) & UART_TX_MASCARA;
+	}
+	txCabeza = cabeza;			// Publicar los datos de una vez para la ISR
+	UCSR0B |= (1<<UDRIE0);		// Arrancar (o mantener) la transmision
+	return 1;
+}
+
+uint8_t UART_Recibir(uint8_t *dato)
+{
+	if (!(UCSR0A & (1<<RXC0)))
+	{
+		return 0;
+	}
+	*dato = UDR0;
+	return 1;
+}
+
+// Registro de datos vacio: enviar el siguiente byte o apagar la interrupcion
+ISR(USART0_UDRE_vect)
+{
+	uint8_t cola = txCola;
+
+	if (cola == txCabeza)
+	{
+		UCSR0B &= ~(1<<UDRIE0);
+		return;
+	}
+	UDR0 = txBuffer[cola];
+	txCola = (cola + 1) & UART_TX_MASCARA;
+}
@@ -0,0 +1,33 @@
+/*
+ * UART.h
+ *
+ * Created: 18/08/2025 09:20:33
+ *  Author: valen
+ */ 
+
+
+#ifndef UART_H_
+#define UART_H_
+
+#include <avr/io.h>
+#include <stdint.h>
+
+// Tamano del buffer circular de transmision (debe ser potencia de 2)
+#define UART_TX_TAM 128
+
+// Inicializa el USART0 en modo doble velocidad (U2X): transmision por
+// interrupcion y recepcion por consulta (comandos de depuracion)
+// A 16 MHz: 1000000 -> UBRR = 1 (0 % de error), 2000000 -> UBRR = 0
+void UART_init(uint32_t baudrate);
+
+// Bytes libres en el buffer de transmision
+uint8_t UART_Libre(void);
+
+// Copia n bytes al buffer y arranca la transmision por interrupcion
+// No bloquea: devuelve 0 (sin copiar nada) si no caben todos
+uint8_t UART_Escribir(const uint8_t *datos, uint8_t n);
+
+// Devuelve 1 y guarda el byte si llego uno por RX, 0 si no hay datos
+uint8_t UART_Recibir(uint8_t *dato);
+
+#endif /* UART_H_ */
@@ -7,111 +7,698 @@
 
 #define F_CPU 16000000 // Frecuencia del CPU, necesaria para las funciones de _delay
 #include <avr/io.h>    // Librera principal de registros del microcontrolador AVR
+#include <avr/interrupt.h> // Librera para manejo de interrupciones
 #include <util/delay.h> // Librera para funciones de retardo
 #include "LCD_8bits.h"  // Librera para el manejo de LCD en modo 8 bits
 #include "I2C.h"        // Librera personalizada para protocolo I2C
+#include "Timer.h"      // Base de tiempo en ms/us (Timer2)
+#include "Telemetria.h" // Tramas binarias por UART para registrar las muestras
+#include "Traza.h"      // Traza opcional de los estados del TWI (TRAZA_TWI)
+#include "Bitacora.h"   // Registro de muestras en EEPROM (escritura en segundo plano)
+#include "UART.h"       // Recepcin de comandos de depuracin
+#include "Pila.h"       // Uso mximo de la pila y margen de SRAM
+#include "Estadistica.h" // Mnimo, mximo, media y desvo de las ltimas lecturas
 
 // Direcciones de esclavos I2C
 #define slave_1 0x30 // Direccin del esclavo 1 (Contador)
 #define slave_2 0x40 // Direccin del esclavo 2 (ADC)
 
+// Registros de los esclavos (ver Registros.h de cada proyecto)
+#define REG_CONTEO 0x01 // Esclavo 1: cuenta de 32 bits (little-endian)
+#define REG_ADC8   0x00 // Esclavo 2: lectura en 8 bits
+
+// Cada esclavo se lee en una sola transaccin de LECTURA_LARGO bytes: el valor
+// y, en las mismas posiciones en ambos, las marcas del reloj de red (us)
+#define LECTURA_LARGO  13
+#define OFS_TS_MUESTRA 4  // u32 tiempo en que el esclavo tom la muestra
+#define OFS_TS_LATCH   8  // u32 tiempo en que el esclavo recibi el latch
+#define OFS_EVENTOS    12 // Esclavo 2: eventos de umbral pendientes
+
+// Cola de eventos del esclavo 2: leer 8 bytes desde REG_EVENTOS saca el ms viejo
+#define REG_EVENTOS    0x0C
+#define EVENTO_LARGO   8  // Pendientes (u8), tipo (u8), valor (u16), tiempo de red (u32)
+
+// Bloque de diagnstico de la traza del TWI (igual en ambos esclavos)
+#define REG_TRAZA_CUENTA 0x30 // u8 eventos guardados, seguido de REG_TRAZA_SEL y del evento
+#define REG_TRAZA_SEL    0x31 // Escribir n congela la traza y publica el evento n
+
+// Uso de la SRAM de los esclavos: .data + .bss, pila mxima y margen (3 x u16)
+#define REG_RAM_ESTATICA 0x36
+#define MEMORIA_LARGO    6
+
+// Correccin de frecuencia del reloj de red de los esclavos (i16, 0.1 ppm)
+#define REG_DERIVA       0x3C
+
+// Modo de conteo del esclavo 1: solo en MODO_BOTONES la cuenta es un valor;
+// en los otros modos crece siempre y la estadstica usa los incrementos
+#define REG_MODO     0x20
+#define MODO_BOTONES 0
+
+// Tiempo que el ttulo reemplaza las etiquetas de la primera fila (no bloquea)
+#define SPLASH_MS 1500
+
+// Sondeo adaptativo: cada esclavo se lee con su propio intervalo, entre un
+// mnimo y un mximo (se pueden cambiar con -D al compilar). Mientras el valor
+// no cambia el intervalo se duplica; al cambiar vuelve de inmediato al mnimo
+#ifndef SONDEO_MIN_MS
+#define SONDEO_MIN_MS 50
+#endif
+#ifndef SONDEO_MAX_MS
+#define SONDEO_MAX_MS 800
+#endif
+
+// Refresco del display: no ms seguido que DISPLAY_MIN_MS (parpadeo del LCD)
+// y al menos cada DISPLAY_MAX_MS aunque no cambien los valores (fin del ttulo)
+#define DISPLAY_MIN_MS 100
+#define DISPLAY_MAX_MS 1000
+
+// Pginas del display; el botn de PC0 (a GND, con pull-up) pasa a la siguiente
+#define PAGINA_NUMEROS 0 // Contador y ADC en nmeros
+#define PAGINA_BARRA   1 // ADC como barra horizontal
+#define PAGINA_GRAFICA 2 // ADC como grfica que se desplaza
+#define PAGINA_EST_ADC 3 // Estadstica de las ltimas lecturas del ADC
+#define PAGINA_EST_CONTADOR 4 // dem del contador
+#define NUM_PAGINAS    5
+#define BOTON_PAGINA   PINC0
+#define BOTON_MS       200 // Rebote: se ignora otra pulsacin antes de este tiempo
+
+// Refresco de las pginas grficas (25 Hz): solo se envan las celdas y filas
+// de glifo que cambiaron, as que no hace falta esperar a que cambie el valor
+#define GRAFICO_MS 40
+
+// Perodo de la sincronizacin de los relojes de los esclavos
+#define SINC_MS 1000
+
+// Cada cunto se guardan en la EEPROM los valores que cambiaron: con 256
+// registros alcanza para varios minutos de historia
+#define BITACORA_MS 1000
+
+// Perodo del reporte de uso de la SRAM de los tres nodos
+#define MEMORIA_MS 5000
+
+// Perodo del envo de la estadstica de cada esclavo por telemetra
+#define ESTADISTICA_MS 1000
+
+// ndices de los esclavos en los bitmaps y en la tabla de sondeo
+#define ESCLAVO_CONTADOR 0
+#define ESCLAVO_ADC      1
+#define NUM_ESCLAVOS     2
+
+typedef struct
+{
+	uint16_t minimo;    // Intervalo mnimo entre lecturas (ms)
+	uint16_t maximo;    // Intervalo mximo con el valor estable (ms)
+	uint16_t intervalo; // Intervalo actual (ms)
+	uint8_t umbral;     // Diferencia que todava se considera estable (ruido)
+	uint32_t proximo;   // millis() de la prxima lectura
+	uint32_t ultimo;    // ltimo valor ledo
+} Sondeo;
+
 // Variables
-uint8_t direccion;
 uint8_t temp;
-uint8_t bufferI2C;
-uint8_t bufferI2C_2;
-uint8_t valorI2C = 0;    // Valor recibido del esclavo 1 (contador)
+uint8_t datosI2C[LECTURA_LARGO]; // Bytes ledos de los registros de un esclavo
+uint32_t valorI2C = 0;   // Valor recibido del esclavo 1 (contador)
 uint8_t valorI2C_2 = 0;  // Valor recibido del esclavo 2 (ADC)
+uint16_t tiempoArranque = 0; // ms desde el reset hasta la primera muestra en pantalla
+uint32_t tsMuestra[NUM_ESCLAVOS]; // Tiempo de red de la muestra leda de cada esclavo
+int32_t desfase[NUM_ESCLAVOS];    // Latch del esclavo menos latch del maestro (us)
+uint16_t volcadoBitacora = BITACORA_REGISTROS; // Prximo registro a volcar (BITACORA_REGISTROS = sin volcado)
+uint8_t pagina = PAGINA_NUMEROS; // Pgina que muestra el display
+Estadistica estadisticas[NUM_ESCLAVOS]; // Ventana de las ltimas lecturas de cada esclavo
+uint8_t modoContador = MODO_BOTONES; // ltimo modo ledo del esclavo 1
+uint32_t conteoAnterior;             // Cuenta de la lectura anterior (incrementos)
+uint8_t conteoValido = 0;            // conteoAnterior es del modo actual
+
+Sondeo sondeos[NUM_ESCLAVOS] = {
+	{SONDEO_MIN_MS, SONDEO_MAX_MS, SONDEO_MIN_MS, 0, 0, 0}, // Contador: solo cambia con los botones o pulsos
+	{SONDEO_MIN_MS, SONDEO_MAX_MS, SONDEO_MIN_MS, 1, 0, 0}, // ADC: se ignora el ruido de 1
+};
+
+// Prototipos de funciones
+uint8_t leerEsclavos(uint8_t pendientes);
+uint8_t ajustarSondeo(Sondeo *s, uint32_t valor, uint32_t ahora);
+void actualizarDisplay(void);
+uint8_t botonPagina(uint32_t ahora);
+void mostrarPagina(void);
+void actualizarGrafico(void);
+void volcarTrazas(void);
+void reportarTiempos(uint8_t cuales);
+void volcarBitacora(void);
+void leerEventos(uint8_t direccion, uint8_t pendientes);
+void reportarMemoria(void);
+void reportarDeriva(void);
+void leerModoContador(void);
+void actualizarEstadistica(void);
+void reportarEstadisticas(void);
 
 int main(void)
 {
-	// Inicializacin de LCD e I2C
-	initLCD8(); // Inicializa el LCD en modo 8 bits
+	uint8_t causaReset = MCUSR; // Guarda la causa del reset (watchdog, brown-out, ...)
+	uint8_t esclavos;
+	uint8_t pendientes, cambios = 0;
+	uint32_t ahora, ultimoDisplay, ultimaSinc, ultimaBitacora, ultimaMemoria, ultimaEstadistica;
+	MCUSR = 0;
+
+	// ========== ARRANQUE RPIDO ==========
+	// El LCD necesita 15 ms desde que se alimenta antes de aceptar instrucciones;
+	// en ese tiempo se inicializa el I2C, se buscan los esclavos y se toma la
+	// primera lectura, en vez de esperar sin hacer nada
+	Timer_init();               // Base de tiempo para medir el arranque y la telemetra
+	sei();                      // Habilita interrupciones globales
+	LCD8_Pines();               // Pines del LCD; desde aqu corre la espera de encendido
 	I2C_Master_Init(100000, 1); // Inicializa el I2C a 100kHz, como maestro
+	Telemetria_init();          // UART a 1 Mbaud, transmisin por interrupcin
+	Bitacora_init();            // Busca dnde qued la bitcora antes del reset
+	DDRC &= ~(1 << DDC0);       // Botn de pgina como entrada
+	PORTC |= (1 << PORTC0);     // con pull-up
+	for (uint8_t i = 0; i < NUM_ESCLAVOS; i++)
+	{
+		Estadistica_Iniciar(&estadisticas[i]);
+	}
 
-	// Mensaje de bienvenida en la pantalla
-	LCD8_Clear();
-	LCD8_Set_Cursor(0, 0);
-	LCD8_Write_String("Sistema I2C");
-	LCD8_Set_Cursor(0, 1);
-	LCD8_Write_String("Iniciando...");
-	_delay_ms(2000); // Espera 2 segundos
+	esclavos = 0;
+	if (I2C_Master_Probar(slave_1)) esclavos |= (1 << 0);
+	if (I2C_Master_Probar(slave_2)) esclavos |= (1 << 1);
+	I2C_Master_Sincronizar(); // Reloj de red comn antes de la primera muestra
+	leerModoContador();
+	ultimaSinc = millis();
+	leerEsclavos((1 << NUM_ESCLAVOS) - 1); // Primera lectura ya disponible para la primera pantalla
+
+	while (millis() < LCD8_ENCENDIDO_MS); // Solo lo que falte de la espera de encendido
+	LCD8_Configurar();
+
+	// La primera pantalla ya muestra valores reales (con el ttulo arriba)
+	actualizarDisplay();
+	tiempoArranque = millis();
+	ultimoDisplay = tiempoArranque;
+	ultimaBitacora = tiempoArranque;
+	ultimaMemoria = tiempoArranque;
+	ultimaEstadistica = tiempoArranque;
+	Telemetria_Arranque(tiempoArranque, causaReset, esclavos);
 
 	while (1)
 	{
+		// Comandos por el UART: 'T' vuelca las trazas del TWI, 'E' la bitcora
+		if (UART_Recibir(&temp))
+		{
+			if (temp == 'T')
+			{
+				volcarTrazas();
+			}
+			else if (temp == 'E')
+			{
+				volcadoBitacora = 0;
+			}
+		}
+		volcarBitacora(); // Un registro por vuelta, sin esperar
+
+		// ========== SINCRONIZACIN DE RELOJES ==========
+		ahora = millis();
+		if (ahora - ultimaSinc >= SINC_MS)
+		{
+			I2C_Master_Sincronizar();
+			reportarDeriva(); // Deriva que cada esclavo estim con esta sincronizacin
+			leerModoContador();
+			ultimaSinc = ahora;
+		}
+
+		// ========== COMUNICACIN I2C ==========
+		// Solo se leen los esclavos a los que ya les toca segn su intervalo
+		pendientes = 0;
+		for (uint8_t i = 0; i < NUM_ESCLAVOS; i++)
+		{
+			if ((int32_t)(ahora - sondeos[i].proximo) >= 0)
+			{
+				pendientes |= (1 << i);
+			}
+		}
+		if (pendientes)
+		{
+			cambios |= leerEsclavos(pendientes);
+		}
+
 		// ========== ACTUALIZACIN DEL DISPLAY ==========
-		LCD8_Clear(); // Limpia la pantalla LCD
+		ahora = millis();
+		if (botonPagina(ahora))
+		{
+			pagina = (pagina + 1) % NUM_PAGINAS;
+			mostrarPagina();
+			ultimoDisplay = ahora;
+		}
 
-		// Mostrar valor del contador (esclavo 1)
-		LCD8_Set_Cursor(0, 0);
-		LCD8_Write_String("Contador: ");
-		LCD8_Set_Cursor(4, 1);
-		LCD8_Variable_U(valorI2C); // Muestra valor numrico sin signo
+		if (pagina == PAGINA_BARRA || pagina == PAGINA_GRAFICA)
+		{
+			if (ahora - ultimoDisplay >= GRAFICO_MS)
+			{
+				actualizarGrafico();
+				reportarTiempos(cambios);
+				ultimoDisplay = ahora;
+				cambios = 0;
+			}
+		}
+		// Pginas de texto: solo cuando cambi algn valor (o para quitar el ttulo a tiempo)
+		else if ((cambios && ahora - ultimoDisplay >= DISPLAY_MIN_MS) || ahora - ultimoDisplay >= DISPLAY_MAX_MS)
+		{
+			if (pagina == PAGINA_NUMEROS)
+			{
+				actualizarDisplay();
+			}
+			else
+			{
+				actualizarEstadistica();
+			}
+			reportarTiempos(cambios); // Latencia de los valores nuevos en pantalla
+			ultimoDisplay = ahora;
+			cambios = 0;
+		}
 
-		// Mostrar valor del ADC (esclavo 2)
-		LCD8_Set_Cursor(11, 0);
-		LCD8_Write_String("ADC: ");
-		LCD8_Set_Cursor(12, 1);
-		LCD8_Variable_U(valorI2C_2); // Muestra valor numrico sin signo
+		// ========== BITCORA EN EEPROM ==========
+		// Solo se encolan los valores que cambiaron; la ISR de la EEPROM los escribe
+		if (ahora - ultimaBitacora >= BITACORA_MS)
+		{
+			Bitacora_Registrar(ESCLAVO_CONTADOR, valorI2C, ahora);
+			Bitacora_Registrar(ESCLAVO_ADC, valorI2C_2, ahora);
+			ultimaBitacora = ahora;
+		}
+
+		// ========== ESTADSTICA ==========
+		if (ahora - ultimaEstadistica >= ESTADISTICA_MS)
+		{
+			reportarEstadisticas();
+			ultimaEstadistica = ahora;
+		}
+
+		// ========== USO DE LA SRAM ==========
+		if (ahora - ultimaMemoria >= MEMORIA_MS)
+		{
+			reportarMemoria();
+			ultimaMemoria = ahora;
+		}
+	}
+}
+
+// Valor de 32 bits en little-endian
+static uint32_t leer_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Guarda las marcas de tiempo recin ledas en datosI2C; "latch" es el tiempo
+// del maestro al congelar, as que la diferencia es el desfase de ese reloj
+static void guardarTiempos(uint8_t esclavo, uint32_t latch)
+{
+	tsMuestra[esclavo] = leer_u32(&datosI2C[OFS_TS_MUESTRA]);
+	desfase[esclavo] = (int32_t)(leer_u32(&datosI2C[OFS_TS_LATCH]) - latch);
+}
+
+// Congela el dato de todos los esclavos y lee los indicados en "pendientes";
+// devuelve qu valores cambiaron (bit 0 = contador, bit 1 = ADC)
+uint8_t leerEsclavos(uint8_t pendientes)
+{
+	uint8_t cambios = 0;
+	uint32_t ahora = millis();
+	uint32_t latch;
+
+	// ========== LLAMADA GENERAL - LATCH DE TODOS LOS ESCLAVOS ==========
+	// Un solo comando hace que todos los esclavos congelen su dato en el mismo
+	// instante; luego se leen uno por uno los valores congelados
+	I2C_Master_Broadcast(I2C_CMD_LATCH);
+	latch = micros(); // Incluye el STOP: unos pocos us despus del latch real
+
+	// ========== CONTADOR ==========
+	// La cuenta de 32 bits se lee en una sola transaccin, por lo que llega completa
+	if (pendientes & (1 << ESCLAVO_CONTADOR)){
+		temp = I2C_Master_Leer_Registros(slave_1, REG_CONTEO, datosI2C, LECTURA_LARGO);
+		if (temp == 1){
+			valorI2C = leer_u32(&datosI2C[0]);
+			guardarTiempos(ESCLAVO_CONTADOR, latch);
+			if (modoContador == MODO_BOTONES)
+			{
+				Estadistica_Agregar(&estadisticas[ESCLAVO_CONTADOR], valorI2C);
+			}
+			else if (conteoValido && valorI2C >= conteoAnterior)
+			{
+				// Flancos desde la lectura anterior: con pulsos la cuenta cambia en
+				// cada lectura y el sondeo se queda en SONDEO_MIN_MS. Si la cuenta
+				// baj, el esclavo la reinici (p. ej. al cambiar REG_PROMEDIO) sin
+				// cambiar de modo: esa lectura solo sirve de nueva referencia
+				Estadistica_Agregar(&estadisticas[ESCLAVO_CONTADOR], valorI2C - conteoAnterior);
+			}
+			conteoAnterior = valorI2C;
+			conteoValido = 1;
+			Telemetria_Muestra(tsMuestra[ESCLAVO_CONTADOR], slave_1, REG_CONTEO, valorI2C); // Registro de la muestra (no bloquea)
+		}
+		// Un esclavo que no responde tambin se consulta cada vez menos
+		if (ajustarSondeo(&sondeos[ESCLAVO_CONTADOR], valorI2C, ahora)){
+			cambios |= (1 << ESCLAVO_CONTADOR);
+		}
+	}
+
+	// ========== ADC ==========
+	if (pendientes & (1 << ESCLAVO_ADC)){
+		temp = I2C_Master_Leer_Registros(slave_2, REG_ADC8, datosI2C, LECTURA_LARGO);
+		if (temp == 1){
+			valorI2C_2 = datosI2C[0];
+			guardarTiempos(ESCLAVO_ADC, latch);
+			Estadistica_Agregar(&estadisticas[ESCLAVO_ADC], valorI2C_2);
+			Telemetria_Muestra(tsMuestra[ESCLAVO_ADC], slave_2, REG_ADC8, valorI2C_2);
+			// Los eventos solo cuestan una lectura extra cuando hay alguno
+			if (datosI2C[OFS_EVENTOS]){
+				leerEventos(slave_2, datosI2C[OFS_EVENTOS]);
+			}
+		}
+		if (ajustarSondeo(&sondeos[ESCLAVO_ADC], valorI2C_2, ahora)){
+			cambios |= (1 << ESCLAVO_ADC);
+		}
+	}
+
+	return cambios;
+}
+
+// Saca de la cola del esclavo los eventos pendientes y los enva por telemetra
+void leerEventos(uint8_t direccion, uint8_t pendientes)
+{
+	uint8_t evento[EVENTO_LARGO];
+
+	// Cada lectura completa quita un evento; el primer byte dice cuntos quedaban
+	while (pendientes &&
+	       I2C_Master_Leer_Registros(direccion, REG_EVENTOS, evento, EVENTO_LARGO) == 1 &&
+	       evento[0])
+	{
+		Telemetria_Evento(direccion, evento[1], evento[2] | ((uint16_t)evento[3] << 8), leer_u32(&evento[4]));
+		pendientes = evento[0] - 1;
+	}
+}
+
+// Programa la prxima lectura de un esclavo segn si su valor cambi:
+// al cambiar se vuelve al intervalo mnimo, si no el intervalo se duplica
+// hasta el mximo. Devuelve 1 si el valor cambi
+uint8_t ajustarSondeo(Sondeo *s, uint32_t valor, uint32_t ahora)
+{
+	uint32_t diferencia = (valor > s->ultimo) ? valor - s->ultimo : s->ultimo - valor;
+	uint8_t cambio = diferencia > s->umbral;
+
+	if (cambio)
+	{
+		s->intervalo = s->minimo;
+		s->ultimo = valor;
+	}
+	else if (s->intervalo < s->maximo / 2)
+	{
+		s->intervalo *= 2;
+	}
+	else
+	{
+		s->intervalo = s->maximo;
+	}
+	s->proximo = ahora + s->intervalo;
+	return cambio;
+}
+
+// Enva la latencia sensor-pantalla y el desfase de reloj de los esclavos
+// indicados (los que acaban de cambiar en el display)
+void reportarTiempos(uint8_t cuales)
+{
+	const uint8_t direcciones[NUM_ESCLAVOS] = {slave_1, slave_2};
+	uint32_t ahora = micros();
+
+	for (uint8_t i = 0; i < NUM_ESCLAVOS; i++)
+	{
+		if (cuales & (1 << i))
+		{
+			Telemetria_Tiempo(direcciones[i], ahora - tsMuestra[i], desfase[i]);
+		}
+	}
+}
+
+// Enva el siguiente registro de la bitcora si hay un volcado en curso, hay
+// lugar en el UART y la EEPROM no est escribiendo (si no, en la prxima vuelta)
+void volcarBitacora(void)
+{
+	uint8_t registro[4];
+
+	if (volcadoBitacora < BITACORA_REGISTROS &&
+	    UART_Libre() >= TELE_BITACORA_LARGO + 4 &&
+	    Bitacora_Leer(volcadoBitacora, registro))
+	{
+		Telemetria_Bitacora(volcadoBitacora, registro);
+		volcadoBitacora++;
+	}
+}
 
-		_delay_ms(600); // Espera para que se actualice el display correctamente
+// Enva la deriva del cristal de cada esclavo respecto del maestro
+void reportarDeriva(void)
+{
+	const uint8_t direcciones[NUM_ESCLAVOS] = {slave_1, slave_2};
+	uint8_t deriva[2];
 
-		// ========== COMUNICACIN I2C - CONTADOR ==========
-		I2C_Master_Start(); // Inicio de comunicacin I2C
-		// Direccin de esclavo 1 + escritura (bit 0 = 0)
-		bufferI2C = slave_1 << 1 & 0b11111110;
-		temp = I2C_Master_Write(bufferI2C); // Enviar direccin del esclavo
-		if(temp != 1){
-			I2C_Master_Stop(); // Si no responde, se detiene
-		} else {
-			I2C_Master_Write('R'); // Se enva comando 'R' para pedir dato
-			I2C_Master_Stop(); // Se finaliza la comunicacin
+	for (uint8_t i = 0; i < NUM_ESCLAVOS; i++)
+	{
+		if (I2C_Master_Leer_Registros(direcciones[i], REG_DERIVA, deriva, sizeof(deriva)) == 1)
+		{
+			Telemetria_Deriva(direcciones[i], (int16_t)(deriva[0] | ((uint16_t)deriva[1] << 8)));
 		}
+	}
+}
 
-		_delay_ms(10); // Espera breve
+// Lee el modo del esclavo contador; si cambi, la ventana vuelve a empezar
+// porque mezclara valores con incrementos
+void leerModoContador(void)
+{
+	uint8_t nuevo;
 
-		I2C_Master_Start(); // Nueva comunicacin para lectura
-		bufferI2C = slave_1 << 1 | 0b00000001; // Direccin + lectura (bit 0 = 1)
-		temp = I2C_Master_Write(bufferI2C);
-		if (temp != 1){
-			I2C_Master_Stop(); // Si no responde, se detiene
-		} else{
-			TWCR0 = (1<<TWINT)|(1<<TWEN); // Habilitar lectura sin ACK
-			while (!(TWCR0 & (1<<TWINT))); // Espera hasta que se reciba el dato
-			valorI2C = TWDR0; // Guarda el dato recibido
-			I2C_Master_Stop(); // Finaliza la comunicacin
+	if (I2C_Master_Leer_Registros(slave_1, REG_MODO, &nuevo, 1) == 1 && nuevo != modoContador)
+	{
+		modoContador = nuevo;
+		conteoValido = 0;
+		Estadistica_Iniciar(&estadisticas[ESCLAVO_CONTADOR]);
+	}
+}
+
+// Enva el uso de la SRAM del maestro y de los esclavos que respondan
+void reportarMemoria(void)
+{
+	const uint8_t direcciones[NUM_ESCLAVOS] = {slave_1, slave_2};
+	uint8_t memoria[MEMORIA_LARGO];
+
+	Telemetria_Memoria(0, Pila_Estatica(), Pila_Maxima(), Pila_Libre());
+	for (uint8_t i = 0; i < NUM_ESCLAVOS; i++)
+	{
+		// Medido por el esclavo despus del ltimo latch
+		if (I2C_Master_Leer_Registros(direcciones[i], REG_RAM_ESTATICA, memoria, MEMORIA_LARGO) == 1)
+		{
+			Telemetria_Memoria(direcciones[i], memoria[0] | ((uint16_t)memoria[1] << 8),
+			                   memoria[2] | ((uint16_t)memoria[3] << 8), memoria[4] | ((uint16_t)memoria[5] << 8));
 		}
-		_delay_ms(10); // Espera breve
+	}
+}
+
+// Enva por telemetra la traza del TWI del maestro y de los esclavos
+// (sin TRAZA_TWI al compilar, todas las trazas estn vacas)
+void volcarTrazas(void)
+{
+	const uint8_t direcciones[2] = {slave_1, slave_2};
+	uint8_t evento[4];
+	uint8_t diag[6]; // Cuenta, seleccin y evento seleccionado (4 bytes)
+	uint8_t i;
 
-		// ========== COMUNICACIN I2C - ADC ==========
-		I2C_Master_Start(); // Inicia comunicacin
-		bufferI2C_2 = slave_2 << 1 & 0b11111110; // Direccin de esclavo 2 + escritura
-		temp = I2C_Master_Write(bufferI2C_2);
-		if(temp != 1){
-			I2C_Master_Stop(); // Detiene si hay error
-		} else {
-			I2C_Master_Write('L'); // Se enva comando 'L' para pedir lectura de ADC
-			I2C_Master_Stop();
+	// ========== MAESTRO ==========
+	Traza_Congelar(1); // Las transacciones del volcado no se registran
+	for (i = 0; Traza_Leer(i, evento); i++)
+	{
+		while (UART_Libre() < TELE_TRAZA_LARGO + 4); // El volcado no debe perder tramas
+		Telemetria_Traza(0, i, evento);
+	}
+
+	// ========== ESCLAVOS ==========
+	// Al escribir REG_TRAZA_SEL el esclavo congela su traza y publica el evento
+	// elegido; la cuenta se lee despus de congelar, junto con el evento
+	for (uint8_t e = 0; e < 2; e++)
+	{
+		i = 0;
+		while (I2C_Master_Escribir_Registro(direcciones[e], REG_TRAZA_SEL, i) == 1 &&
+		       I2C_Master_Leer_Registros(direcciones[e], REG_TRAZA_CUENTA, diag, sizeof(diag)) == 1 &&
+		       i < diag[0])
+		{
+			while (UART_Libre() < TELE_TRAZA_LARGO + 4);
+			Telemetria_Traza(direcciones[e], i, &diag[2]);
+			i++;
 		}
+		I2C_Master_Escribir_Registro(direcciones[e], REG_TRAZA_SEL, TRAZA_REANUDAR);
+	}
+	Traza_Congelar(0);
+}
+
+// Devuelve 1 una vez por cada pulsacin del botn de pgina
+uint8_t botonPagina(uint32_t ahora)
+{
+	static uint8_t anterior = 1 << BOTON_PAGINA; // Suelto (pull-up)
+	static uint32_t ultimaPulsacion = 0;
+	uint8_t actual = PINC & (1 << BOTON_PAGINA);
+	uint8_t pulsado = 0;
+
+	// Flanco de bajada fuera del tiempo de rebote
+	if (anterior && !actual && ahora - ultimaPulsacion >= BOTON_MS)
+	{
+		ultimaPulsacion = ahora;
+		pulsado = 1;
+	}
+	anterior = actual;
+	return pulsado;
+}
+
+// Dibuja la parte fija de la pgina actual y carga sus caracteres propios
+void mostrarPagina(void)
+{
+	LCD8_Clear();
+	switch (pagina)
+	{
+		case PAGINA_BARRA:
+			LCD8_Barra_Iniciar();
+			LCD8_Set_Cursor(0, 0);
+			LCD8_Write_String("ADC (0-255)");
+			actualizarGrafico();
+			break;
+
+		case PAGINA_GRAFICA:
+			LCD8_Set_Cursor(0, 0);
+			LCD8_Write_String("ADC");
+			LCD8_Grafica_Iniciar(0, 1);
+			break;
+
+		case PAGINA_EST_ADC:
+		case PAGINA_EST_CONTADOR:
+			actualizarEstadistica();
+			break;
+
+		default:
+			actualizarDisplay();
+			break;
+	}
+}
+
+// Escribe un valor en dcimas en a lo sumo "ancho" columnas: con un decimal
+// si cabe, si no redondeado a entero (y saturado si tampoco cabe)
+static void escribirDecimas(uint32_t v, uint8_t ancho)
+{
+	uint32_t limite = 1;
+
+	for (uint8_t i = 2; i < ancho; i++)
+	{
+		limite *= 10; // Dgitos enteros que dejan lugar al punto y al decimal
+	}
+	if (v / 10 < limite)
+	{
+		LCD8_Variable_U32(v / 10);
+		LCD8_Write_Char('.');
+		LCD8_Write_Char('0' + v % 10);
+		return;
+	}
+	v = (v + 5) / 10;
+	limite *= 100;
+	if (v >= limite)
+	{
+		v = limite - 1;
+	}
+	LCD8_Variable_U32(v);
+}
 
-		_delay_ms(10); // Espera breve
+// Mnimo, mximo, media y desvo de la ventana del esclavo de la pgina:
+//   m12   M200  ADC
+//   x150.3 s12.4      (x con barra y sigma de la ROM del LCD)
+// La media ocupa las columnas 1 a 8 y el desvo las 10 a 15
+void actualizarEstadistica(void)
+{
+	EstadisticaResultado r;
+	uint8_t esclavo = (pagina == PAGINA_EST_ADC) ? ESCLAVO_ADC : ESCLAVO_CONTADOR;
+
+	Estadistica_Resultado(&estadisticas[esclavo], &r); // Solo una divisin y una raz
+	LCD8_Clear();
+
+	LCD8_Set_Cursor(0, 0);
+	LCD8_Write_Char('m');
+	LCD8_Variable_U32(r.minimo);
+	LCD8_Set_Cursor(6, 0);
+	LCD8_Write_Char('M');
+	LCD8_Variable_U32(r.maximo);
+	LCD8_Set_Cursor(13, 0);
+	if (esclavo == ESCLAVO_ADC)
+	{
+		LCD8_Write_String("ADC");
+	}
+	else
+	{
+		LCD8_Write_String((modoContador == MODO_BOTONES) ? "CNT" : "INC"); // Incrementos por lectura
+	}
+
+	LCD8_Set_Cursor(0, 1);
+	LCD8_Write_Char(0xF8); // x con barra (media)
+	escribirDecimas(r.media, 8);
+	LCD8_Set_Cursor(9, 1);
+	LCD8_Write_Char(0xE5); // sigma (desvo)
+	escribirDecimas(r.desvio, 6);
+}
+
+// Enva la estadstica de las ltimas lecturas de cada esclavo que ya tenga alguna
+void reportarEstadisticas(void)
+{
+	const uint8_t direcciones[NUM_ESCLAVOS] = {slave_1, slave_2};
+	EstadisticaResultado r;
 
-		I2C_Master_Start(); // Nueva comunicacin para leer
-		bufferI2C_2 = slave_2 << 1 | 0b00000001; // Direccin + lectura
-		temp = I2C_Master_Write(bufferI2C_2);
-		if (temp != 1){
-			I2C_Master_Stop();
-		} else{
-			TWCR0 = (1<<TWINT)|(1<<TWEN); // Preparar lectura
-			while (!(TWCR0 & (1<<TWINT))); // Espera dato
-			valorI2C_2 = TWDR0; // Guardar valor ledo del ADC
-			I2C_Master_Stop();
+	for (uint8_t i = 0; i < NUM_ESCLAVOS; i++)
+	{
+		Estadistica_Resultado(&estadisticas[i], &r);
+		if (r.cuenta)
+		{
+			Telemetria_Estadistica(direcciones[i], &r);
 		}
-		_delay_ms(10); // Espera entre lecturas
+	}
+}
 
-		// Espera antes de iniciar siguiente ciclo
-		_delay_ms(100);
+// Agrega la muestra actual del ADC a la barra o a la grfica
+void actualizarGrafico(void)
+{
+	if (pagina == PAGINA_BARRA)
+	{
+		LCD8_Barra(1, valorI2C_2, 255);
+	}
+	else
+	{
+		LCD8_Grafica_Agregar(valorI2C_2 >> 5); // 8 alturas
 	}
 }
 
+void actualizarDisplay(void)
+{
+	LCD8_Clear(); // Limpia la pantalla LCD
+
+	LCD8_Set_Cursor(0, 0);
+	if (millis() < SPLASH_MS)
+	{
+		// Ttulo de bienvenida mientras los valores ya se muestran abajo
+		if (tiempoArranque)
+		{
+			LCD8_Write_String("Listo en ");
+			LCD8_Variable_U32(tiempoArranque);
+			LCD8_Write_String(" ms");
+		}
+		else
+		{
+			LCD8_Write_String("Sistema I2C");
+		}
+	}
+	else
+	{
+		LCD8_Write_String("Contador: ");
+		LCD8_Set_Cursor(11, 0);
+		LCD8_Write_String("ADC: ");
+	}
+
+	// Mostrar valor del contador (esclavo 1)
+	LCD8_Set_Cursor(0, 1);
+	LCD8_Variable_U32(valorI2C); // Muestra la cuenta completa (hasta 10 dgitos)
 
+	// Mostrar valor del ADC (esclavo 2)
+	LCD8_Set_Cursor(12, 1);
+	LCD8_Variable_U(valorI2C_2); // Muestra valor numrico sin signo
+}